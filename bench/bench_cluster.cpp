@@ -0,0 +1,207 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "cluster_management_system.h"
+#include "basic_queue.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "cow_deque.h"
+#include "heap_queue.h"
+#include "fair_share_queue.h"
+#include "scheduler_registry.h"
+#include "partitioned_cluster.h"
+
+template<uint64_t Width>
+static void bench_finish_programs(benchmark_state& state)
+{
+    const uint64_t processors = state.arg();
+    cluster_management_system<basic_queue> cms(processors);
+    std::vector<program_info> programs(processors / Width, { Width, 1 });
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        cms.add_programs(programs);
+        cms.tick();
+        state.resume_timing();
+
+        cms.tick();
+    }
+    state.add_ticks(state.iterations());
+    state.add_items(state.iterations() * processors);
+}
+
+static void bench_start_programs(benchmark_state& state)
+{
+    const uint64_t processors = state.arg();
+    cluster_management_system<basic_queue> cms(processors);
+    std::vector<program_info> programs(processors, { 1, 1 });
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        cms.add_programs(programs);
+        state.resume_timing();
+
+        cms.tick();
+
+        state.pause_timing();
+        cms.tick();
+        state.resume_timing();
+    }
+    state.add_ticks(state.iterations());
+    state.add_items(state.iterations() * processors);
+}
+
+template<typename System>
+static void run_ticks(benchmark_state& state, System& cms)
+{
+    const uint64_t processors = state.arg();
+    std::default_random_engine g(0);
+    std::uniform_int_distribution<uint64_t> processorsDist(1, processors / 8);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 200);
+    std::bernoulli_distribution arrivalDist(0.3);
+
+    std::vector<program_info> arrivals;
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        if (arrivalDist(g))
+        {
+            arrivals.push_back({ processorsDist(g), ticksDist(g) });
+            cms.add_programs(arrivals);
+            arrivals.clear();
+        }
+        state.resume_timing();
+
+        cms.tick();
+    }
+    state.add_ticks(state.iterations());
+}
+
+template<typename T, uint32_t CoresPerNode = 0>
+static void bench_tick(benchmark_state& state)
+{
+    const uint64_t processors = state.arg();
+    cluster_management_system<T> cms = CoresPerNode == 0
+        ? cluster_management_system<T>(processors)
+        : cluster_management_system<T>(cluster_topology((uint32_t)(processors / CoresPerNode), CoresPerNode, 16));
+    run_ticks(state, cms);
+}
+
+static void bench_simulator_tick(benchmark_state& state, const std::string& spec)
+{
+    std::unique_ptr<cluster_simulator> simulator = default_scheduler_registry().create(spec, state.arg());
+    run_ticks(state, *simulator);
+}
+
+template<typename T>
+static void bench_run_until(benchmark_state& state)
+{
+    const uint64_t processors = state.arg();
+    std::default_random_engine g(0);
+    std::uniform_int_distribution<uint64_t> processorsDist(1, processors);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 2000);
+
+    cluster_management_system<T> cms(processors);
+    const uint64_t startTick = cms.current_tick();
+    while (state.keep_running())
+    {
+        cms.add_program({ processorsDist(g), ticksDist(g) });
+        cms.run_until(cms.current_tick() + 1000);
+    }
+    state.add_ticks(cms.current_tick() - startTick);
+}
+
+// Four equal partitions advanced 100 ticks per sync point.
+static void bench_partitioned_run_until(benchmark_state& state, size_t threads)
+{
+    const uint64_t processors = state.arg();
+    std::vector<partition_config> partitions;
+    for (int i = 0; i < 4; ++i)
+    {
+        partitions.push_back({ "p" + std::to_string(i), "easy:lookahead=100", processors, true, true });
+    }
+
+    partitioned_cluster cluster(partitions, default_scheduler_registry(), threads, 100);
+    std::default_random_engine g(0);
+    std::uniform_int_distribution<uint64_t> processorsDist(1, processors / 8);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 200);
+
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        for (size_t i = 0; i < partitions.size(); ++i)
+        {
+            for (int j = 0; j < 30; ++j)
+            {
+                cluster.add_program(i, { processorsDist(g), ticksDist(g) });
+            }
+        }
+        state.resume_timing();
+
+        cluster.run_until(cluster.current_tick() + 100);
+    }
+    state.add_ticks(cluster.current_tick());
+}
+
+template<typename T>
+static void bench_fork(benchmark_state& state)
+{
+    const uint64_t queued = state.arg();
+    cluster_management_system<T> cms(64);
+    std::vector<program_info> programs(queued, { 64, 10 });
+    cms.add_programs(programs);
+    cms.tick();
+
+    while (state.keep_running())
+    {
+        cluster_management_system<T> fork = cms.fork();
+        fork.tick();
+        do_not_optimize(fork.current_tick());
+    }
+    state.add_items(state.iterations());
+}
+
+static void bench_simulator_fork(benchmark_state& state, const std::string& spec)
+{
+    const uint64_t queued = state.arg();
+    std::unique_ptr<cluster_simulator> simulator = default_scheduler_registry().create(spec, 64);
+    simulator->add_programs(std::vector<program_info>(queued, { 64, 10 }));
+    simulator->tick();
+
+    while (state.keep_running())
+    {
+        std::unique_ptr<cluster_simulator> fork = simulator->fork();
+        fork->tick();
+        do_not_optimize(fork->current_tick());
+    }
+    state.add_items(state.iterations());
+}
+
+static const std::vector<uint64_t> sizes = { 64, 1024, 4096, 65536 };
+
+static benchmark_registration finish_programs("cluster/finish_programs", bench_finish_programs<1>, sizes);
+static benchmark_registration finish_wide_programs("cluster/finish_programs_64_wide", bench_finish_programs<64>, sizes);
+static benchmark_registration start_programs("cluster/try_start_program", bench_start_programs, sizes);
+static benchmark_registration basic_tick("cluster<basic_queue>/tick", bench_tick<basic_queue>, sizes);
+static benchmark_registration planning_tick("cluster<planning_queue<100>>/tick", bench_tick<planning_queue<100>>, sizes);
+static benchmark_registration simulator_tick("simulator<planning:lookahead=100>/tick",
+    [](benchmark_state& state) { bench_simulator_tick(state, "planning:lookahead=100"); }, sizes);
+static benchmark_registration conservative_tick("simulator<conservative>/tick",
+    [](benchmark_state& state) { bench_simulator_tick(state, "conservative"); }, sizes);
+static benchmark_registration easy_tick("cluster<easy_backfill_queue<100>>/tick", bench_tick<easy_backfill_queue<100>>, sizes);
+static benchmark_registration sjf_tick("cluster<sjf_queue<1>>/tick", bench_tick<sjf_queue<1>>, sizes);
+static benchmark_registration fair_share_tick("cluster<fair_share_queue<1000>>/tick", bench_tick<fair_share_queue<1000>>, sizes);
+static benchmark_registration topology_tick("cluster<easy_backfill_queue<100>>/tick_32_core_nodes", bench_tick<easy_backfill_queue<100>, 32>, sizes);
+static benchmark_registration basic_run_until("cluster<basic_queue>/run_until", bench_run_until<basic_queue>, sizes);
+static benchmark_registration partitioned_serial("partitioned<4 x easy:lookahead=100>/run_until",
+    [](benchmark_state& state) { bench_partitioned_run_until(state, 1); }, sizes);
+static benchmark_registration partitioned_parallel("partitioned<4 x easy:lookahead=100>/run_until_4_threads",
+    [](benchmark_state& state) { bench_partitioned_run_until(state, 4); }, sizes);
+static benchmark_registration linked_list_fork("cluster<basic_queue>/fork", bench_fork<basic_queue>, { 1024, 65536, 1048576 });
+static benchmark_registration cow_deque_fork("cluster<fifo_queue<cow_deque>>/fork", bench_fork<fifo_queue<cow_deque>>, { 1024, 65536, 1048576 });
+static benchmark_registration simulator_fork("simulator<basic>/fork",
+    [](benchmark_state& state) { bench_simulator_fork(state, "basic"); }, { 1024, 65536, 1048576 });
\ No newline at end of file
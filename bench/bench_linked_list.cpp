@@ -0,0 +1,72 @@
+#include "benchmark.h"
+#include "linked_list.h"
+#include "ring_buffer.h"
+#include "program_info.h"
+
+template<template<typename> class Storage>
+static void bench_push_pop(benchmark_state& state)
+{
+    Storage<std::pair<uint64_t, program_info>> storage;
+    for (uint64_t i = 0; i < state.arg(); ++i)
+    {
+        storage.push_back({ i, { 1, 1 } });
+    }
+
+    uint64_t id = state.arg();
+    while (state.keep_running())
+    {
+        storage.push_back({ id++, { 1, 1 } });
+        storage.pop_front();
+    }
+    do_not_optimize(storage.front());
+    state.add_items(state.iterations());
+}
+
+template<template<typename> class Storage>
+static void bench_erase(benchmark_state& state)
+{
+    Storage<std::pair<uint64_t, program_info>> storage;
+    for (uint64_t i = 0; i < state.arg() + 2; ++i)
+    {
+        storage.push_back({ i, { 1, 1 } });
+    }
+
+    uint64_t id = state.arg() + 2;
+    while (state.keep_running())
+    {
+        storage.erase(++storage.begin());
+        storage.push_back({ id++, { 1, 1 } });
+    }
+    do_not_optimize(storage.back());
+    state.add_items(state.iterations());
+}
+
+template<template<typename> class Storage>
+static void bench_scan(benchmark_state& state)
+{
+    Storage<std::pair<uint64_t, program_info>> storage;
+    for (uint64_t i = 0; i < state.arg(); ++i)
+    {
+        storage.push_back({ i, { 1, 1 } });
+    }
+
+    while (state.keep_running())
+    {
+        uint64_t sum = 0;
+        for (const auto& p : storage)
+        {
+            sum += p.first;
+        }
+        do_not_optimize(sum);
+    }
+    state.add_items(state.iterations() * state.arg());
+}
+
+static const std::vector<uint64_t> depths = { 10, 1000, 100000, 1000000 };
+
+static benchmark_registration linked_list_push_pop("linked_list/push_pop", bench_push_pop<linked_list>, depths);
+static benchmark_registration linked_list_erase("linked_list/erase", bench_erase<linked_list>, depths);
+static benchmark_registration linked_list_scan("linked_list/scan", bench_scan<linked_list>, depths);
+static benchmark_registration ring_buffer_push_pop("ring_buffer/push_pop", bench_push_pop<ring_buffer>, depths);
+static benchmark_registration ring_buffer_erase("ring_buffer/erase", bench_erase<ring_buffer>, depths);
+static benchmark_registration ring_buffer_scan("ring_buffer/scan", bench_scan<ring_buffer>, depths);
\ No newline at end of file
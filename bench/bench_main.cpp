@@ -0,0 +1,66 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "benchmark.h"
+
+std::vector<benchmark_case>& benchmark_registry()
+{
+    static std::vector<benchmark_case> registry;
+    return registry;
+}
+
+static benchmark_state run_case(const benchmark_case& bench, uint64_t arg, double minTime)
+{
+    uint64_t iterations = 1;
+    while (true)
+    {
+        benchmark_state state(iterations, arg);
+        bench.function(state);
+
+        if (state.seconds() >= minTime || iterations >= 1000000000)
+        {
+            return state;
+        }
+
+        double grow = state.seconds() > 0 ? 1.4 * minTime / state.seconds() : 10.0;
+        if (grow > 10.0) grow = 10.0;
+        if (grow < 2.0) grow = 2.0;
+        iterations = (uint64_t)(iterations * grow);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+    double minTime = argc > 2 ? std::stod(argv[2]) : 0.2;
+
+    std::cout << std::left << std::setw(48) << "Benchmark"
+        << std::right << std::setw(14) << "Iterations"
+        << std::setw(16) << "ns/op"
+        << std::setw(16) << "ticks/sec"
+        << std::setw(16) << "items/sec" << "\n";
+
+    for (const auto& bench : benchmark_registry())
+    {
+        for (uint64_t arg : bench.args)
+        {
+            std::string name = bench.name + "/" + std::to_string(arg);
+            if (name.find(filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            benchmark_state state = run_case(bench, arg, minTime);
+            std::cout << std::left << std::setw(48) << name
+                << std::right << std::setw(14) << state.iterations()
+                << std::setw(16) << std::fixed << std::setprecision(1) << state.seconds() * 1e9 / state.iterations()
+                << std::setw(16) << std::setprecision(0);
+            if (state.ticks() > 0) std::cout << state.ticks() / state.seconds(); else std::cout << "-";
+            std::cout << std::setw(16);
+            if (state.items() > 0) std::cout << state.items() / state.seconds(); else std::cout << "-";
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <random>
+#include "benchmark.h"
+#include "basic_queue.h"
+#include "priority_queue.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
+#include "heap_queue.h"
+
+static const uint64_t cluster_processors = 4096;
+static const uint64_t free_processors = 32;
+
+static cluster_state make_busy_state()
+{
+    cluster_state state{ free_processors, 1000, std::vector<processor_state>(cluster_processors) };
+    for (uint64_t i = 0; i < 128; ++i)
+    {
+        state.completions.add(1001 + i * 10, (cluster_processors - free_processors) / 128);
+    }
+    return state;
+}
+
+template<typename T>
+static void bench_blocked_get(benchmark_state& state)
+{
+    std::default_random_engine g(0);
+    std::uniform_int_distribution<uint64_t> processorsDist(free_processors + 1, cluster_processors);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 2000);
+
+    T queue;
+    for (uint64_t i = 0; i < state.arg(); ++i)
+    {
+        queue.push({ processorsDist(g), ticksDist(g) }, 1000);
+    }
+
+    const cluster_state busy = make_busy_state();
+    while (state.keep_running())
+    {
+        auto program = queue.get(busy);
+        do_not_optimize(program);
+    }
+    state.add_items(state.iterations());
+}
+
+static const std::vector<uint64_t> depths = { 10, 1000, 100000, 1000000 };
+
+static benchmark_registration basic_get("basic_queue/get", bench_blocked_get<basic_queue>, depths);
+static benchmark_registration priority_get("priority_queue<inf>/get", bench_blocked_get<priority_queue<UINT64_MAX>>, depths);
+static benchmark_registration planning_get("planning_queue<100>/get", bench_blocked_get<planning_queue<100>>, depths);
+static benchmark_registration easy_get("easy_backfill_queue<100>/get", bench_blocked_get<easy_backfill_queue<100>>, depths);
+static benchmark_registration conservative_get("conservative_backfill_queue<100>/get", bench_blocked_get<conservative_backfill_queue<100>>, depths);
+static benchmark_registration sjf_get("sjf_queue<1>/get", bench_blocked_get<sjf_queue<1>>, depths);
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class benchmark_state
+{
+private:
+    using clock = std::chrono::steady_clock;
+
+    uint64_t mIterations;
+    uint64_t mRemaining;
+    uint64_t mArg;
+    uint64_t mTicks;
+    uint64_t mItems;
+    bool mStarted;
+    bool mPaused;
+    clock::time_point mStart;
+    clock::duration mElapsed;
+
+public:
+    benchmark_state(uint64_t iterations, uint64_t arg)
+        : mIterations(iterations), mRemaining(iterations), mArg(arg), mTicks(0), mItems(0),
+        mStarted(false), mPaused(false), mElapsed(clock::duration::zero())
+    {}
+
+    uint64_t iterations() const noexcept { return mIterations; }
+    uint64_t arg() const noexcept { return mArg; }
+    uint64_t ticks() const noexcept { return mTicks; }
+    uint64_t items() const noexcept { return mItems; }
+    double seconds() const noexcept { return std::chrono::duration<double>(mElapsed).count(); }
+
+    bool keep_running()
+    {
+        if (!mStarted)
+        {
+            mStarted = true;
+            mStart = clock::now();
+        }
+
+        if (mRemaining == 0)
+        {
+            if (!mPaused)
+            {
+                mElapsed += clock::now() - mStart;
+                mPaused = true;
+            }
+            return false;
+        }
+
+        --mRemaining;
+        return true;
+    }
+
+    void pause_timing()
+    {
+        if (!mPaused)
+        {
+            mElapsed += clock::now() - mStart;
+            mPaused = true;
+        }
+    }
+
+    void resume_timing()
+    {
+        if (mPaused)
+        {
+            mPaused = false;
+            mStart = clock::now();
+        }
+    }
+
+    void add_ticks(uint64_t ticks) noexcept { mTicks += ticks; }
+    void add_items(uint64_t items) noexcept { mItems += items; }
+};
+
+using benchmark_function = std::function<void(benchmark_state&)>;
+
+struct benchmark_case
+{
+    std::string name;
+    benchmark_function function;
+    std::vector<uint64_t> args;
+};
+
+std::vector<benchmark_case>& benchmark_registry();
+
+struct benchmark_registration
+{
+    benchmark_registration(const std::string& name, benchmark_function function, std::vector<uint64_t> args = { 0 })
+    {
+        benchmark_registry().push_back({ name, std::move(function), std::move(args) });
+    }
+};
+
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#ifdef _MSC_VER
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "cluster_state.h"
+
+class availability_profile
+{
+private:
+    std::vector<std::pair<uint64_t, uint64_t>> mSteps;
+
+    static uint64_t end_tick(uint64_t start, uint64_t duration) noexcept
+    {
+        return duration > UINT64_MAX - start ? UINT64_MAX : start + duration;
+    }
+
+    size_t step_index(uint64_t tick) const noexcept
+    {
+        auto it = std::upper_bound(mSteps.begin(), mSteps.end(), tick,
+            [](uint64_t t, const std::pair<uint64_t, uint64_t>& step) { return t < step.first; });
+        return it == mSteps.begin() ? 0 : (size_t)(it - mSteps.begin()) - 1;
+    }
+
+    size_t split(uint64_t tick)
+    {
+        size_t i = step_index(tick);
+        if (mSteps[i].first >= tick)
+        {
+            return i;
+        }
+
+        mSteps.insert(mSteps.begin() + i + 1, { tick, mSteps[i].second });
+        return i + 1;
+    }
+
+public:
+    availability_profile() = default;
+    availability_profile(const cluster_state& state)
+    {
+        mSteps.push_back({ state.currentTick, state.freeProcessors });
+        for (const auto& release : state.completions)
+        {
+            uint64_t tick = release.first > state.currentTick ? release.first : state.currentTick + 1;
+            uint64_t freeAfter = mSteps.back().second + release.second;
+            if (mSteps.back().first == tick)
+            {
+                mSteps.back().second = freeAfter;
+            } else
+            {
+                mSteps.push_back({ tick, freeAfter });
+            }
+        }
+    }
+
+    uint64_t start_tick() const noexcept { return mSteps.front().first; }
+
+    // Drops the steps that ended before tick.
+    void advance(uint64_t tick)
+    {
+        const size_t i = step_index(tick);
+        mSteps.erase(mSteps.begin(), mSteps.begin() + i);
+        if (mSteps.front().first < tick)
+        {
+            mSteps.front().first = tick;
+        }
+    }
+
+    uint64_t free_at(uint64_t tick) const noexcept
+    {
+        return mSteps[step_index(tick)].second;
+    }
+
+    uint64_t earliest_start(uint64_t processors, uint64_t duration) const noexcept
+    {
+        for (size_t i = 0; i < mSteps.size(); ++i)
+        {
+            if (mSteps[i].second < processors)
+            {
+                continue;
+            }
+
+            const uint64_t end = end_tick(mSteps[i].first, duration);
+            size_t j = i + 1;
+            while (j < mSteps.size() && mSteps[j].first < end && mSteps[j].second >= processors)
+            {
+                ++j;
+            }
+
+            if (j == mSteps.size() || mSteps[j].first >= end)
+            {
+                return mSteps[i].first;
+            }
+
+            i = j;
+        }
+
+        return UINT64_MAX;
+    }
+
+    void reserve(uint64_t start, uint64_t duration, uint64_t processors)
+    {
+        if (start < start_tick())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't reserve processors in the past.");
+        }
+
+        const uint64_t end = end_tick(start, duration);
+        const size_t first = split(start);
+        const size_t last = end == UINT64_MAX ? mSteps.size() : split(end);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            if (mSteps[i].second < processors)
+            {
+                throw std::logic_error(__FUNCTION__ ": not enough free processors to reserve.");
+            }
+        }
+
+        for (size_t i = first; i < last; ++i)
+        {
+            mSteps[i].second -= processors;
+        }
+    }
+
+    // Undoes a reservation, or frees processors of a program that finished before its limit.
+    void release(uint64_t start, uint64_t duration, uint64_t processors)
+    {
+        if (start < start_tick())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't release processors in the past.");
+        }
+
+        const uint64_t end = end_tick(start, duration);
+        const size_t first = split(start);
+        const size_t last = end == UINT64_MAX ? mSteps.size() : split(end);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            mSteps[i].second += processors;
+        }
+    }
+};
\ No newline at end of file
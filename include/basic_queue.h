@@ -2,15 +2,17 @@
 #include <optional>
 #include "linked_list.h"
 #include "program_info.h"
+#include "queue_traits.h"
 #include "cluster_state.h"
 
-class basic_queue
+template<template<typename> class Storage = linked_list>
+class fifo_queue
 {
 private:
     uint64_t mNextId;
-    linked_list<std::pair<uint64_t, program_info>> mPrograms;
+    Storage<std::pair<uint64_t, program_info>> mPrograms;
 public:
-    basic_queue() : mNextId(0) {}
+    fifo_queue() : mNextId(0) {}
 
     std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
     {
@@ -30,4 +32,32 @@ public:
         mPrograms.push_back({ id, program });
         return id;
     }
-};
\ No newline at end of file
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        return push_programs(mPrograms, mNextId, programs, count);
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& p : mPrograms)
+        {
+            f(p);
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        mPrograms.save(writer);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        mPrograms.load(reader);
+    }
+};
+
+using basic_queue = fifo_queue<>;
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Values are written in host byte order: snapshots are meant to be resumed on the same platform.
+class binary_writer
+{
+private:
+    static const size_t buffer_size = 1 << 16;
+
+    std::ostream& mStream;
+    std::vector<char> mBuffer;
+    size_t mUsed;
+
+public:
+    binary_writer(std::ostream& stream);
+    binary_writer(const binary_writer&) = delete;
+    ~binary_writer();
+
+    binary_writer& operator=(const binary_writer&) = delete;
+
+    void write_bytes(const void* data, size_t size);
+    void flush();
+
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written directly");
+        write_bytes(&value, sizeof(T));
+    }
+
+    template<typename A, typename B>
+    void write(const std::pair<A, B>& value)
+    {
+        write(value.first);
+        write(value.second);
+    }
+
+    template<typename T>
+    void write(const std::vector<T>& values)
+    {
+        write<uint64_t>(values.size());
+        if constexpr (std::is_trivially_copyable<T>::value)
+        {
+            write_bytes(values.data(), values.size() * sizeof(T));
+        } else
+        {
+            for (const T& value : values)
+            {
+                write(value);
+            }
+        }
+    }
+
+    template<typename K, typename V>
+    void write(const std::map<K, V>& values)
+    {
+        write<uint64_t>(values.size());
+        for (const auto& value : values)
+        {
+            write(value.first);
+            write(value.second);
+        }
+    }
+
+    void write(const std::string& value);
+
+    // For objects that only expose their state through stream operators, such as standard random engines.
+    template<typename T>
+    void write_text(const T& value)
+    {
+        std::ostringstream text;
+        text << value;
+        write(text.str());
+    }
+};
+
+class binary_reader
+{
+private:
+    static const size_t buffer_size = 1 << 16;
+
+    std::istream& mStream;
+    std::vector<char> mBuffer;
+    size_t mPosition;
+    size_t mAvailable;
+
+public:
+    binary_reader(std::istream& stream);
+    binary_reader(const binary_reader&) = delete;
+
+    binary_reader& operator=(const binary_reader&) = delete;
+
+    void read_bytes(void* data, size_t size);
+
+    template<typename T>
+    void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read directly");
+        read_bytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    T read()
+    {
+        T value;
+        read(value);
+        return value;
+    }
+
+    template<typename A, typename B>
+    void read(std::pair<A, B>& value)
+    {
+        read(value.first);
+        read(value.second);
+    }
+
+    template<typename T>
+    void read(std::vector<T>& values)
+    {
+        const uint64_t size = read<uint64_t>();
+        values.clear();
+
+        // Grow in chunks so that a corrupted size fails on the stream rather than on allocation.
+        const uint64_t chunk = buffer_size / sizeof(T) + 1;
+        for (uint64_t done = 0; done < size; )
+        {
+            const uint64_t count = size - done < chunk ? size - done : chunk;
+            values.resize(done + count);
+            if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                read_bytes(values.data() + done, count * sizeof(T));
+            } else
+            {
+                for (uint64_t i = done; i < done + count; ++i)
+                {
+                    read(values[i]);
+                }
+            }
+            done += count;
+        }
+    }
+
+    template<typename K, typename V>
+    void read(std::map<K, V>& values)
+    {
+        const uint64_t size = read<uint64_t>();
+        values.clear();
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            K key;
+            read(key);
+            read(values[key]);
+        }
+    }
+
+    void read(std::string& value);
+
+    template<typename T>
+    void read_text(T& value)
+    {
+        std::istringstream text(read<std::string>());
+        text >> value;
+        if (text.fail())
+        {
+            throw std::runtime_error(__FUNCTION__ ": malformed text value.");
+        }
+    }
+};
\ No newline at end of file
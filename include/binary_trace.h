@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "trace_job.h"
+
+struct binary_trace_block
+{
+    uint64_t offset;
+    uint64_t firstSubmitTick;
+};
+
+class binary_trace_writer
+{
+private:
+    std::ofstream mStream;
+    std::vector<binary_trace_block> mIndex;
+    std::vector<unsigned char> mBlock;
+    uint32_t mBlockSize;
+    uint32_t mBlockJobs;
+    uint64_t mJobCount;
+    uint64_t mOffset;
+    uint64_t mLastSubmitTick;
+    bool mClosed;
+
+    void flush_block();
+
+public:
+    binary_trace_writer(const std::string& path, uint32_t blockSize = 4096);
+    binary_trace_writer(const binary_trace_writer&) = delete;
+    ~binary_trace_writer();
+
+    binary_trace_writer& operator=(const binary_trace_writer&) = delete;
+
+    void write(const trace_job& job);
+    void close();
+
+    uint64_t job_count() const noexcept { return mJobCount; }
+};
+
+class binary_trace_reader
+{
+private:
+    std::optional<mapped_file> mFile;
+    const unsigned char* mData;
+    const unsigned char* mCurrent;
+    const unsigned char* mBlockEnd;
+    const unsigned char* mIndex;
+    uint32_t mVersion;
+    uint32_t mBlockSize;
+    uint64_t mJobCount;
+    uint64_t mBlockCount;
+    uint64_t mJob;
+    uint64_t mLastSubmitTick;
+
+    void open(size_t size);
+    binary_trace_block block(uint64_t index) const noexcept;
+    void enter_block(uint64_t index);
+
+public:
+    binary_trace_reader(const std::string& path);
+    binary_trace_reader(const char* data, size_t size);
+
+    bool next(trace_job& job);
+    void seek_block(uint64_t index);
+    void seek(uint64_t submitTick);
+
+    uint64_t job_count() const noexcept { return mJobCount; }
+    uint64_t block_count() const noexcept { return mBlockCount; }
+    uint64_t position() const noexcept { return mJob; }
+};
+
+template<typename Reader>
+uint64_t convert_trace(Reader& reader, binary_trace_writer& writer)
+{
+    trace_job job;
+    uint64_t count = 0;
+    while (reader.next(job))
+    {
+        writer.write(job);
+        ++count;
+    }
+
+    writer.close();
+    return count;
+}
\ No newline at end of file
@@ -1,41 +1,112 @@
 #pragma once
 #include <optional>
+#include <atomic>
+#include <memory>
+#include <type_traits>
 #include <cstdint>
 #include <vector>
 #include <exception>
-#include <unordered_set>
+#include <algorithm>
+#include <functional>
 #include "program_info.h"
 #include "cluster_statistics.h"
+#include "latency_histogram.h"
+#include "load_timeline.h"
+#include "mpsc_queue.h"
+#include "binary_io.h"
 #include "cluster_state.h"
+#include "cluster_topology.h"
 #include "processor_state.h"
+#include "queue_traits.h"
 
 template<typename T>
 class cluster_management_system
 {
 private:
+    template<typename> friend class cluster_management_system;
+
+    struct fork_tag {};
+
+    struct submission_channel
+    {
+        mpsc_queue<program_info> queue;
+        std::atomic<uint64_t> processors;
+
+        submission_channel(uint64_t processorCount) : processors(processorCount) {}
+    };
+
     T mQueue;
     cluster_state mState;
+    std::vector<std::pair<uint64_t, uint32_t>> mCompletions;
 
     uint64_t mProgramsAdded;
     uint64_t mProgramsDone;
     uint64_t mProgramsStarted;
+    uint64_t mProgramsKilled;
+    uint64_t mProgramsMigrated;
     uint64_t mTotalLoad;
+    uint64_t mCapacityTicks;
+    uint64_t mCapacityTick;
+    uint64_t mNodesSpanned;
 
-    void finish_programs()
+    latency_histogram mWaitTime;
+    latency_histogram mTurnaroundTime;
+    latency_histogram mBoundedSlowdown;
+    load_timeline mTimeline;
+    std::vector<program_info> mArrivals;
+    std::unique_ptr<submission_channel> mSubmissions;
+    std::vector<program_info> mSubmitted;
+
+    bool mHasArrivals;
+
+    static constexpr uint64_t snapshot_magic = 0x50414e5332504d; // "MP2SNAP"
+    static constexpr uint32_t snapshot_version = 8;
+
+    void record_completion(const running_program& program)
     {
-        std::unordered_set<uint64_t> completedPrograms;
+        const uint64_t runTime = program.tickEnd - program.tickStart;
+        const uint64_t turnaround = program.tickEnd - program.tickSubmitted;
+        const uint64_t bound = runTime > cluster_statistics::slowdown_threshold ? runTime : cluster_statistics::slowdown_threshold;
+        const uint64_t slowdown = (turnaround * cluster_statistics::slowdown_scale + bound / 2) / bound;
+
+        mTurnaroundTime.record(turnaround);
+        mBoundedSlowdown.record(slowdown > cluster_statistics::slowdown_scale ? slowdown : cluster_statistics::slowdown_scale);
+    }
 
-        for (auto& p : mState.processors)
+    void finish_programs()
+    {
+        while (!mCompletions.empty() && mCompletions.front().first <= mState.currentTick)
         {
-            if (p.busy && p.tickEnd <= mState.currentTick)
+            std::pop_heap(mCompletions.begin(), mCompletions.end(), std::greater<std::pair<uint64_t, uint32_t>>());
+            const uint32_t slot = mCompletions.back().second;
+            mCompletions.pop_back();
+
+            const running_program& program = mState.programs[slot];
+            if (!mState.placement.is_empty())
             {
-                p.busy = false;
-                ++mState.freeProcessors;
-                completedPrograms.insert(p.programId);
+                mState.placement.release_chain(program.firstProcessor, mState.processors);
+            }
+
+            for (uint32_t i = program.firstProcessor; i != processor_state::none; )
+            {
+                processor_state& p = mState.processors[i];
+                mState.freeIndex.release(i);
+                i = p.nextProcessor;
+                p = processor_state();
+            }
+            mState.freeProcessors += program.processors;
+            // Schedulers planned with the limit, so an early finish just releases the planned processors sooner.
+            mState.completions.remove(program.tickLimit, program.processors);
+            record_completion(program);
+            mProgramsKilled += program.killed ? 1 : 0;
+            if constexpr (has_on_finish<T>::value)
+            {
+                mQueue.on_finish(program, mState.currentTick);
             }
-        }
 
-        mProgramsDone += completedPrograms.size();
+            mState.programs.erase(slot);
+            ++mProgramsDone;
+        }
     }
 
     bool try_start_program()
@@ -46,45 +117,152 @@ private:
             return false;
         }
 
-        const uint64_t programId = program.value().first;
-        const program_info& program_ref = program.value().second;
-        uint64_t processorsRemain = program_ref.processors;
+        start_program(program.value().first, program.value().second);
+        return true;
+    }
+
+    void start_program(uint64_t programId, const program_info& program_ref)
+    {
+        const uint32_t slot = mState.programs.insert({
+            programId,
+            program_ref.tickSubmitted,
+            mState.currentTick,
+            mState.currentTick + program_ref.run_time(),
+            mState.currentTick + program_ref.executionTime,
+            program_ref.processors,
+            processor_state::none,
+            program_ref.userId,
+            program_ref.exceeds_limit(),
+            true
+        });
 
-        for (auto& p : mState.processors)
+        uint32_t first = processor_state::none;
+        uint32_t last = processor_state::none;
+        auto onAcquired = [&](uint64_t i)
         {
-            if (processorsRemain == 0) break;
-            if (!p.busy)
+            mState.processors[i] = processor_state(slot);
+            if (last == processor_state::none)
+            {
+                first = (uint32_t)i;
+            } else
             {
-                p = processor_state(
-                    mState.currentTick,
-                    mState.currentTick + program_ref.executionTime,
-                    programId,
-                    true
-                );
-
-                --mState.freeProcessors;
-                --processorsRemain;
+                mState.processors[last].nextProcessor = (uint32_t)i;
             }
+            last = (uint32_t)i;
+        };
+
+        if (mState.placement.is_empty())
+        {
+            mState.freeIndex.acquire(program_ref.processors, onAcquired);
+        } else
+        {
+            mNodesSpanned += mState.placement.acquire(program_ref.processors, mState.freeIndex, onAcquired);
         }
+        mState.programs.set_first_processor(slot, first);
+        mState.freeProcessors -= program_ref.processors;
+        mState.completions.add(mState.programs[slot].tickLimit, program_ref.processors);
 
+        mCompletions.push_back({ mState.programs[slot].tickEnd, slot });
+        std::push_heap(mCompletions.begin(), mCompletions.end(), std::greater<std::pair<uint64_t, uint32_t>>());
+        mWaitTime.record(mState.currentTick - program_ref.tickSubmitted);
         ++mProgramsStarted;
+    }
 
-        return true;
+    void drain_submissions()
+    {
+        program_info program;
+        while (mSubmissions->queue.try_pop(program))
+        {
+            mSubmitted.push_back(program);
+        }
+
+        if (!mSubmitted.empty())
+        {
+            add_programs(mSubmitted);
+            mSubmitted.clear();
+        }
     }
 
     uint64_t get_tick_load()
     {
         return mState.processors.size() - mState.freeProcessors;
     }
+
+    uint64_t next_completion_tick() const
+    {
+        return mCompletions.empty() ? UINT64_MAX : mCompletions.front().first;
+    }
+
+    // Nothing can finish or start before the next completion unless new programs arrive,
+    // so the ticks in between differ only by the load they add.
+    void skip_idle_ticks(uint64_t targetTick)
+    {
+        if (targetTick <= mState.currentTick)
+        {
+            return;
+        }
+
+        mTotalLoad += get_tick_load() * (targetTick - mState.currentTick);
+        mTimeline.record(get_tick_load(), waiting_programs(), targetTick - mState.currentTick);
+        mState.currentTick = targetTick;
+    }
+
+    // Forks share the processor table and, with cow_deque storage, the queue contents until
+    // either side writes to them. Waiting programs are re-queued when the policy changes.
+    template<typename Other>
+    cluster_management_system(const cluster_management_system<Other>& other, fork_tag)
+        : mState(other.mState), mCompletions(other.mCompletions),
+        mProgramsAdded(other.mProgramsAdded), mProgramsDone(other.mProgramsDone), mProgramsStarted(other.mProgramsStarted), mProgramsKilled(other.mProgramsKilled), mProgramsMigrated(other.mProgramsMigrated),
+        mTotalLoad(other.mTotalLoad), mCapacityTicks(other.mCapacityTicks), mCapacityTick(other.mCapacityTick), mNodesSpanned(other.mNodesSpanned),
+        mWaitTime(other.mWaitTime), mTurnaroundTime(other.mTurnaroundTime), mBoundedSlowdown(other.mBoundedSlowdown),
+        mTimeline(other.mTimeline), mSubmissions(std::make_unique<submission_channel>(other.processors())),
+        mHasArrivals(other.mHasArrivals)
+    {
+        if constexpr (std::is_same<T, Other>::value)
+        {
+            mQueue = other.mQueue;
+        } else
+        {
+            std::vector<std::pair<uint64_t, program_info>> waiting;
+            other.mQueue.for_each([&](const std::pair<uint64_t, program_info>& p) { waiting.push_back(p); });
+            std::sort(waiting.begin(), waiting.end(),
+                [](const std::pair<uint64_t, program_info>& a, const std::pair<uint64_t, program_info>& b) { return a.first < b.first; });
+
+            for (const auto& p : waiting)
+            {
+                mQueue.push(p.second, p.second.tickSubmitted);
+            }
+            mHasArrivals = true;
+        }
+    }
 public:
     cluster_management_system(uint64_t processors)
-        : mState{ processors, 0, std::vector<processor_state>(processors) },
-        mProgramsAdded(0), mProgramsDone(0), mProgramsStarted(0), mTotalLoad(0)
+        : mState{ processors, 0, cow_vector<processor_state>(processors), free_processor_index(processors) },
+        mProgramsAdded(0), mProgramsDone(0), mProgramsStarted(0), mProgramsKilled(0), mProgramsMigrated(0), mTotalLoad(0), mCapacityTicks(0), mCapacityTick(0), mNodesSpanned(0),
+        mSubmissions(std::make_unique<submission_channel>(processors)), mHasArrivals(false)
     {
         if (processors < 1)
         {
             throw std::invalid_argument(__FUNCTION__ ": cluster must have at least one processor.");
         }
+
+        if (processors >= processor_state::none)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": cluster has too many processors.");
+        }
+    }
+
+    cluster_management_system(uint64_t processors, T queue)
+        : cluster_management_system(processors)
+    {
+        mQueue = std::move(queue);
+    }
+
+    // Programs are placed onto as few nodes of the topology as possible.
+    cluster_management_system(const cluster_topology& topology)
+        : cluster_management_system(topology.processors())
+    {
+        mState.placement = topology_placement(topology);
     }
 
     void add_program(const program_info& info)
@@ -94,13 +272,65 @@ public:
             throw std::invalid_argument(__FUNCTION__ ": can't add program that requires more processors than cluster has.");
         }
 
-        mQueue.push(info, mState.currentTick);
+        program_info program = info;
+        program.tickSubmitted = mState.currentTick;
+        mQueue.push(program, mState.currentTick);
         ++mProgramsAdded;
+        mHasArrivals = true;
+    }
+
+    void add_programs(const program_info* programs, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (programs[i].processors > mState.processors.size())
+            {
+                throw std::invalid_argument(__FUNCTION__ ": can't add program that requires more processors than cluster has.");
+            }
+        }
+
+        mArrivals.assign(programs, programs + count);
+        for (program_info& program : mArrivals)
+        {
+            program.tickSubmitted = mState.currentTick;
+        }
+
+        if constexpr (has_push_batch<T>::value)
+        {
+            mQueue.push_batch(mArrivals.data(), count, mState.currentTick);
+        } else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                mQueue.push(mArrivals[i], mState.currentTick);
+            }
+        }
+
+        mProgramsAdded += count;
+        mHasArrivals = mHasArrivals || count > 0;
+    }
+
+    template<typename Container>
+    void add_programs(const Container& programs)
+    {
+        add_programs(programs.data(), programs.size());
+    }
+
+    // Thread-safe: may be called from any thread while another one drives the simulation.
+    // The program is queued at the start of the next tick.
+    void submit_program(const program_info& info)
+    {
+        if (info.processors > mSubmissions->processors.load(std::memory_order_relaxed))
+        {
+            throw std::invalid_argument(__FUNCTION__ ": can't add program that requires more processors than cluster has.");
+        }
+
+        mSubmissions->queue.push(info);
     }
 
     cluster_statistics get_statistics()
     {
-        double averageLoad = (double)mTotalLoad / (mState.processors.size() * mState.currentTick);
+        double averageLoad = (double)mTotalLoad / (mCapacityTicks + mState.processors.size() * (mState.currentTick - mCapacityTick));
 
         return cluster_statistics(
             mProgramsAdded,
@@ -108,17 +338,217 @@ public:
             mProgramsStarted,
 
             mState.currentTick,
-            averageLoad
+            averageLoad,
+
+            mWaitTime.summary(),
+            mTurnaroundTime.summary(),
+            mBoundedSlowdown.summary(cluster_statistics::slowdown_scale),
+            mProgramsKilled
         );
     }
 
     void tick()
     {
+        begin_tick();
+        end_tick();
+    }
+
+    // tick() in two halves: programs migrated or adopted in between are accounted in this tick.
+    void begin_tick()
+    {
+        drain_submissions();
         ++mState.currentTick;
 
         finish_programs();
         while (try_start_program()) {}
+        mHasArrivals = false;
+    }
 
+    void end_tick()
+    {
         mTotalLoad += get_tick_load();
+        mTimeline.record(get_tick_load(), waiting_programs());
+    }
+
+    void run_until(uint64_t targetTick)
+    {
+        while (mState.currentTick < targetTick)
+        {
+            drain_submissions();
+            if (!mHasArrivals)
+            {
+                uint64_t next = next_completion_tick();
+                skip_idle_ticks((next < targetTick ? next : targetTick) - 1);
+            }
+
+            tick();
+        }
     }
+
+    bool advance_to_next_event()
+    {
+        drain_submissions();
+        if (!mHasArrivals)
+        {
+            uint64_t next = next_completion_tick();
+            if (next == UINT64_MAX)
+            {
+                return false;
+            }
+
+            skip_idle_ticks(next - 1);
+        }
+
+        tick();
+        return true;
+    }
+
+    // Programs submitted from other threads are queued first, exactly as the next tick would do.
+    // The writer is flushed at the end, so a failed write throws here rather than being lost.
+    void save(binary_writer& writer)
+    {
+        drain_submissions();
+
+        writer.write(snapshot_magic);
+        writer.write(snapshot_version);
+        mState.save(writer);
+        mQueue.save(writer);
+        writer.write(mCompletions);
+
+        writer.write(mProgramsAdded);
+        writer.write(mProgramsDone);
+        writer.write(mProgramsStarted);
+        writer.write(mProgramsKilled);
+        writer.write(mProgramsMigrated);
+        writer.write(mTotalLoad);
+        writer.write(mCapacityTicks);
+        writer.write(mCapacityTick);
+        writer.write(mNodesSpanned);
+        writer.write(mHasArrivals);
+
+        mWaitTime.save(writer);
+        mTurnaroundTime.save(writer);
+        mBoundedSlowdown.save(writer);
+        mTimeline.save(writer);
+        writer.flush();
+    }
+
+    void load(binary_reader& reader)
+    {
+        if (reader.read<uint64_t>() != snapshot_magic)
+        {
+            throw std::runtime_error(__FUNCTION__ ": not a cluster snapshot.");
+        }
+
+        if (reader.read<uint32_t>() != snapshot_version)
+        {
+            throw std::runtime_error(__FUNCTION__ ": unsupported cluster snapshot version.");
+        }
+
+        mState.load(reader);
+        if (mState.processors.empty() || mState.processors.size() >= processor_state::none
+            || mState.freeIndex.size() != mState.processors.size() || mState.freeProcessors != mState.freeIndex.free_count()
+            || (!mState.placement.is_empty() && mState.placement.topology().processors() != mState.processors.size()))
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted cluster snapshot.");
+        }
+
+        mQueue.load(reader);
+        reader.read(mCompletions);
+
+        reader.read(mProgramsAdded);
+        reader.read(mProgramsDone);
+        reader.read(mProgramsStarted);
+        reader.read(mProgramsKilled);
+        reader.read(mProgramsMigrated);
+        reader.read(mTotalLoad);
+        reader.read(mCapacityTicks);
+        reader.read(mCapacityTick);
+        reader.read(mNodesSpanned);
+        reader.read(mHasArrivals);
+
+        mWaitTime.load(reader);
+        mTurnaroundTime.load(reader);
+        mBoundedSlowdown.load(reader);
+        mTimeline.load(reader);
+        mSubmissions->processors.store(mState.processors.size(), std::memory_order_relaxed);
+    }
+
+    cluster_management_system fork()
+    {
+        drain_submissions();
+        return cluster_management_system(*this, fork_tag{});
+    }
+
+    template<typename U>
+    cluster_management_system<U> fork_with_policy()
+    {
+        drain_submissions();
+        return cluster_management_system<U>(*this, typename cluster_management_system<U>::fork_tag{});
+    }
+
+    // With a topology the new processors form one more node.
+    void add_processors(uint64_t count)
+    {
+        if (count >= processor_state::none - mState.processors.size())
+        {
+            throw std::invalid_argument(__FUNCTION__ ": cluster has too many processors.");
+        }
+
+        if (!mState.placement.is_empty() && count > 0)
+        {
+            mState.placement.add_node((uint32_t)count);
+        }
+
+        mCapacityTicks += mState.processors.size() * (mState.currentTick - mCapacityTick);
+        mCapacityTick = mState.currentTick;
+
+        mState.processors.resize(mState.processors.size() + count);
+        mState.freeIndex.grow(count);
+        mState.freeProcessors += count;
+        mSubmissions->processors.store(mState.processors.size(), std::memory_order_relaxed);
+
+        // Waiting programs may fit now, so the next tick must not be skipped.
+        mHasArrivals = true;
+    }
+
+    // Lets another system run one of the waiting programs. The queue picks it as if target were
+    // this cluster, so the program is chosen by this policy but fits the other one's processors.
+    std::optional<std::pair<uint64_t, program_info>> migrate_program(const cluster_state& target)
+    {
+        drain_submissions();
+        std::optional<std::pair<uint64_t, program_info>> program = mQueue.get(target);
+        if (program.has_value())
+        {
+            ++mProgramsMigrated;
+            // The program may have blocked the head of the queue, so the next tick must not be skipped.
+            mHasArrivals = true;
+        }
+        return program;
+    }
+
+    // Starts a program taken from another system at the current tick; it keeps its submit tick.
+    // Call it between begin_tick() and end_tick() so the program counts towards this tick's load.
+    void adopt_program(uint64_t programId, const program_info& program)
+    {
+        if (program.processors > mState.freeProcessors)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": not enough free processors to start the program.");
+        }
+
+        ++mProgramsAdded;
+        start_program(programId, program);
+    }
+
+    uint64_t current_tick() const noexcept { return mState.currentTick; }
+    uint64_t free_processors() const noexcept { return mState.freeProcessors; }
+    uint64_t waiting_programs() const noexcept { return mProgramsAdded - mProgramsStarted - mProgramsMigrated; }
+    uint64_t programs_migrated() const noexcept { return mProgramsMigrated; }
+    const cluster_state& state() const noexcept { return mState; }
+    const latency_histogram& wait_times() const noexcept { return mWaitTime; }
+    const latency_histogram& turnaround_times() const noexcept { return mTurnaroundTime; }
+    const latency_histogram& bounded_slowdowns() const noexcept { return mBoundedSlowdown; }
+    uint64_t processors() const noexcept { return mState.processors.size(); }
+    uint64_t nodes_spanned() const noexcept { return mNodesSpanned; }
+    const load_timeline& timeline() const noexcept { return mTimeline; }
 };
\ No newline at end of file
@@ -1,12 +1,51 @@
 #pragma once
 #include <cstdint>
+#include <utility>
 #include <vector>
 #include "processor_state.h"
+#include "cow_vector.h"
+#include "free_processor_index.h"
+#include "topology_placement.h"
+#include "running_program_table.h"
+#include "completion_profile.h"
+#include "binary_io.h"
 
 struct cluster_state
 {
     uint64_t freeProcessors;
     uint64_t currentTick;
 
-    std::vector<processor_state> processors;
+    cow_vector<processor_state> processors;
+    free_processor_index freeIndex;
+    running_program_table programs;
+    completion_profile completions;
+    topology_placement placement;
+
+    // The program table, completions and placement start empty.
+    cluster_state(uint64_t freeProcessors = 0, uint64_t currentTick = 0,
+        cow_vector<processor_state> processors = cow_vector<processor_state>(), free_processor_index freeIndex = free_processor_index())
+        : freeProcessors(freeProcessors), currentTick(currentTick), processors(std::move(processors)), freeIndex(std::move(freeIndex))
+    {}
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(freeProcessors);
+        writer.write(currentTick);
+        processors.save(writer);
+        freeIndex.save(writer);
+        programs.save(writer);
+        completions.save(writer);
+        placement.save(writer);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(freeProcessors);
+        reader.read(currentTick);
+        processors.load(reader);
+        freeIndex.load(reader);
+        programs.load(reader);
+        completions.load(reader);
+        placement.load(reader);
+    }
 };
\ No newline at end of file
@@ -1,28 +1,51 @@
 #pragma once
 #include <cstdint>
 #include <iostream>
+#include "latency_histogram.h"
 
 class cluster_statistics final
 {
+public:
+    // Bounded slowdown is turnaround / max(run time, threshold), kept in 1/scale units.
+    static constexpr uint64_t slowdown_threshold = 10;
+    static constexpr uint64_t slowdown_scale = 1000;
+
 private:
     uint64_t mProgramsAdded;
     uint64_t mProgramsDone;
     uint64_t mProgramsStarted;
+    uint64_t mProgramsKilled;
 
     uint64_t mTicks;
     double mAverageLoad;
 
+    latency_summary mWaitTime;
+    latency_summary mTurnaroundTime;
+    latency_summary mBoundedSlowdown;
+
 public:
     cluster_statistics(uint64_t programsAdded, uint64_t programsDone, uint64_t programsStarted, uint64_t ticks, double averageLoad)
-        : mProgramsAdded(programsAdded), mProgramsDone(programsDone), mProgramsStarted(programsStarted),
-        mTicks(ticks), mAverageLoad(averageLoad)
+        : mProgramsAdded(programsAdded), mProgramsDone(programsDone), mProgramsStarted(programsStarted), mProgramsKilled(0),
+        mTicks(ticks), mAverageLoad(averageLoad), mWaitTime{}, mTurnaroundTime{}, mBoundedSlowdown{}
+    {}
+
+    cluster_statistics(uint64_t programsAdded, uint64_t programsDone, uint64_t programsStarted, uint64_t ticks, double averageLoad,
+        const latency_summary& waitTime, const latency_summary& turnaroundTime, const latency_summary& boundedSlowdown,
+        uint64_t programsKilled = 0)
+        : mProgramsAdded(programsAdded), mProgramsDone(programsDone), mProgramsStarted(programsStarted), mProgramsKilled(programsKilled),
+        mTicks(ticks), mAverageLoad(averageLoad), mWaitTime(waitTime), mTurnaroundTime(turnaroundTime), mBoundedSlowdown(boundedSlowdown)
     {}
 
     uint64_t programs_added() const noexcept { return mProgramsAdded; }
     uint64_t programs_done() const noexcept { return mProgramsDone; }
     uint64_t programs_started() const noexcept { return mProgramsStarted; }
+    uint64_t programs_killed() const noexcept { return mProgramsKilled; }
     uint64_t ticks() const noexcept { return mTicks; }
     double average_load() const noexcept { return mAverageLoad; }
+    const latency_summary& wait_time() const noexcept { return mWaitTime; }
+    const latency_summary& turnaround_time() const noexcept { return mTurnaroundTime; }
+    const latency_summary& bounded_slowdown() const noexcept { return mBoundedSlowdown; }
 };
 
+std::ostream& operator<<(std::ostream& ostr, const latency_summary& summary);
 std::ostream& operator<<(std::ostream& ostr, const cluster_statistics& stats);
\ No newline at end of file
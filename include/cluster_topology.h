@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "binary_io.h"
+
+// Processors are numbered node by node, so every node owns a contiguous range of them.
+// Racks group nodesPerRack consecutive nodes; zero puts the whole cluster into one rack.
+class cluster_topology
+{
+private:
+    std::vector<uint64_t> mNodeStart;
+    uint32_t mNodesPerRack;
+
+public:
+    cluster_topology() : mNodeStart{ 0 }, mNodesPerRack(0) {}
+
+    cluster_topology(uint32_t nodes, uint32_t coresPerNode, uint32_t nodesPerRack = 0)
+        : cluster_topology(std::vector<uint32_t>(nodes, coresPerNode), nodesPerRack)
+    {}
+
+    cluster_topology(const std::vector<uint32_t>& nodeCores, uint32_t nodesPerRack = 0)
+        : mNodeStart{ 0 }, mNodesPerRack(nodesPerRack)
+    {
+        if (nodeCores.empty())
+        {
+            throw std::invalid_argument(__FUNCTION__ ": topology must have at least one node.");
+        }
+
+        for (uint32_t cores : nodeCores)
+        {
+            add_node(cores);
+        }
+    }
+
+    void add_node(uint32_t cores)
+    {
+        if (cores < 1)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": node must have at least one core.");
+        }
+
+        mNodeStart.push_back(mNodeStart.back() + cores);
+    }
+
+    uint32_t node_count() const noexcept { return (uint32_t)(mNodeStart.size() - 1); }
+    uint64_t processors() const noexcept { return mNodeStart.back(); }
+    uint32_t nodes_per_rack() const noexcept { return mNodesPerRack; }
+
+    uint32_t rack_count() const noexcept
+    {
+        return mNodesPerRack == 0 ? 1 : (node_count() + mNodesPerRack - 1) / mNodesPerRack;
+    }
+
+    uint64_t node_begin(uint32_t node) const { return mNodeStart[node]; }
+    uint64_t node_end(uint32_t node) const { return mNodeStart[node + 1]; }
+    uint64_t node_cores(uint32_t node) const { return mNodeStart[node + 1] - mNodeStart[node]; }
+
+    uint32_t rack_of(uint32_t node) const noexcept { return mNodesPerRack == 0 ? 0 : node / mNodesPerRack; }
+
+    uint32_t node_of(uint64_t processor) const
+    {
+        if (processor >= processors())
+        {
+            throw std::out_of_range(__FUNCTION__ ": processor index is out of range.");
+        }
+
+        return (uint32_t)(std::upper_bound(mNodeStart.begin(), mNodeStart.end(), processor) - mNodeStart.begin() - 1);
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNodesPerRack);
+        writer.write(mNodeStart);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNodesPerRack);
+        reader.read(mNodeStart);
+        if (mNodeStart.empty() || mNodeStart.front() != 0 || std::adjacent_find(mNodeStart.begin(), mNodeStart.end(), std::greater_equal<uint64_t>()) != mNodeStart.end())
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted topology snapshot.");
+        }
+    }
+};
\ No newline at end of file
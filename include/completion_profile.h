@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include "binary_io.h"
+
+class completion_profile
+{
+private:
+    std::map<uint64_t, uint64_t> mReleases;
+
+public:
+    void add(uint64_t tickEnd, uint64_t processors)
+    {
+        mReleases[tickEnd] += processors;
+    }
+
+    void remove(uint64_t tickEnd, uint64_t processors)
+    {
+        auto it = mReleases.find(tickEnd);
+        if (it == mReleases.end() || it->second < processors)
+        {
+            throw std::out_of_range(__FUNCTION__ ": no such processors are released at this tick.");
+        }
+
+        it->second -= processors;
+        if (it->second == 0)
+        {
+            mReleases.erase(it);
+        }
+    }
+
+    bool is_empty() const noexcept { return mReleases.empty(); }
+
+    uint64_t ticks_wait(uint64_t currentTick, uint64_t freeProcessors, uint64_t processorsRequired) const
+    {
+        uint64_t available = freeProcessors;
+        for (const auto& release : mReleases)
+        {
+            available += release.second;
+            if (available >= processorsRequired)
+            {
+                return release.first >= currentTick ? release.first - currentTick + 1 : 1;
+            }
+        }
+
+        return UINT64_MAX;
+    }
+
+    std::map<uint64_t, uint64_t>::const_iterator begin() const noexcept { return mReleases.begin(); }
+    std::map<uint64_t, uint64_t>::const_iterator end() const noexcept { return mReleases.end(); }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mReleases);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mReleases);
+    }
+};
\ No newline at end of file
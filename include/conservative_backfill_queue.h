@@ -0,0 +1,291 @@
+#pragma once
+#include <optional>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include "linked_list.h"
+#include "program_info.h"
+#include "queue_traits.h"
+#include "cluster_state.h"
+#include "availability_profile.h"
+
+// Every program in the look-ahead window holds a reservation at its earliest start behind the
+// programs queued before it, and a program is started only when its reservation comes due.
+// The reservations are kept between calls: a start turns a reservation into a running program
+// without changing the profile, so only a program finishing before its limit moves them, and
+// then each later reservation is compressed towards the freed processors in queue order.
+template<uint64_t LookAhead = UINT64_MAX, template<typename> class Storage = linked_list>
+class conservative_backfill_queue
+{
+private:
+    uint64_t mNextId;
+    uint64_t mLookAhead;
+    Storage<std::pair<uint64_t, program_info>> mPrograms;
+
+    // Reservations of the first mPlanned programs; UINT64_MAX marks a program that never fits.
+    availability_profile mProfile;
+    std::unordered_map<uint64_t, uint64_t> mStarts;
+    std::set<std::pair<uint64_t, uint64_t>> mDue;
+    size_t mPlanned;
+
+    // The state the reservations were made for. Anything the queue didn't see coming, like an
+    // adopted program, added processors or another cluster's state, rebuilds them from scratch.
+    bool mValid;
+    bool mStale;
+    bool mCompress;
+    uint64_t mTick;
+    uint64_t mFree;
+    uint64_t mRunning;
+    uint64_t mCapacity;
+
+    void reserve(const std::pair<uint64_t, program_info>& p)
+    {
+        const uint64_t start = mProfile.earliest_start(p.second.processors, p.second.occupied_ticks());
+        mStarts[p.first] = start;
+        if (start != UINT64_MAX)
+        {
+            mProfile.reserve(start, p.second.occupied_ticks(), p.second.processors);
+            mDue.insert({ start, p.first });
+        }
+    }
+
+    void unreserve(const std::pair<uint64_t, program_info>& p)
+    {
+        const uint64_t start = mStarts[p.first];
+        if (start != UINT64_MAX)
+        {
+            mProfile.release(start, p.second.occupied_ticks(), p.second.processors);
+            mDue.erase({ start, p.first });
+        }
+    }
+
+    void rebuild(const cluster_state& state)
+    {
+        mProfile = availability_profile(state);
+        mStarts.clear();
+        mDue.clear();
+        mPlanned = 0;
+        mValid = true;
+        mStale = false;
+        mCompress = false;
+        mTick = state.currentTick;
+        mFree = state.freeProcessors;
+        mRunning = state.programs.size();
+        mCapacity = state.processors.size();
+    }
+
+    // Rebuilds the profile of a restored queue from the state and the saved reservations.
+    bool restore(const cluster_state& state)
+    {
+        mProfile = availability_profile(state);
+        mDue.clear();
+        mStale = false;
+
+        auto iter = mPrograms.begin();
+        for (size_t i = 0; i < mPlanned; ++i, ++iter)
+        {
+            const uint64_t start = mStarts.at((*iter).first);
+            if (start < state.currentTick)
+            {
+                return false;
+            }
+
+            if (start != UINT64_MAX)
+            {
+                mProfile.reserve(start, (*iter).second.occupied_ticks(), (*iter).second.processors);
+                mDue.insert({ start, (*iter).first });
+            }
+        }
+        return true;
+    }
+
+    void sync(const cluster_state& state)
+    {
+        if (!mValid || state.currentTick < mTick || state.freeProcessors != mFree
+            || state.programs.size() != mRunning || state.processors.size() != mCapacity)
+        {
+            rebuild(state);
+            return;
+        }
+
+        if (mStale && !restore(state))
+        {
+            rebuild(state);
+            return;
+        }
+
+        if (state.currentTick > mTick)
+        {
+            mProfile.advance(state.currentTick);
+            mTick = state.currentTick;
+            // A reservation made at a tick the simulation skipped can't be honoured any more.
+            if (!mDue.empty() && mDue.begin()->first < mTick)
+            {
+                rebuild(state);
+                return;
+            }
+        }
+
+        if (mCompress)
+        {
+            // O(planned * profile steps), paid only on the ticks where a program finished early.
+            mCompress = false;
+            auto iter = mPrograms.begin();
+            for (size_t i = 0; i < mPlanned; ++i, ++iter)
+            {
+                if (mStarts[(*iter).first] > mTick)
+                {
+                    unreserve(*iter);
+                    reserve(*iter);
+                }
+            }
+        }
+    }
+
+    void plan()
+    {
+        const size_t window = mLookAhead < mPrograms.size() ? (size_t)mLookAhead : mPrograms.size();
+        if (mPlanned >= window)
+        {
+            return;
+        }
+
+        auto iter = mPrograms.begin();
+        for (size_t i = 0; i < mPlanned; ++i)
+        {
+            ++iter;
+        }
+
+        for (; mPlanned < window; ++iter, ++mPlanned)
+        {
+            reserve(*iter);
+        }
+    }
+
+public:
+    conservative_backfill_queue(uint64_t lookAhead = LookAhead) : mNextId(0), mLookAhead(lookAhead), mPlanned(0),
+        mValid(false), mStale(false), mCompress(false), mTick(0), mFree(0), mRunning(0), mCapacity(0) {}
+
+    std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
+    {
+        if (mPrograms.size() == 0)
+        {
+            return std::nullopt;
+        }
+
+        sync(state);
+        plan();
+        if (mDue.empty() || mDue.begin()->first != state.currentTick)
+        {
+            return std::nullopt;
+        }
+
+        const uint64_t id = mDue.begin()->second;
+        auto iter = mPrograms.begin();
+        while ((*iter).first != id)
+        {
+            ++iter;
+        }
+
+        std::pair<uint64_t, program_info> tmp = *iter;
+        mPrograms.erase(iter);
+        mDue.erase(mDue.begin());
+        mStarts.erase(id);
+        --mPlanned;
+        mFree -= tmp.second.processors;
+        ++mRunning;
+        return tmp;
+    }
+
+    uint64_t push(const program_info& program, uint64_t tick)
+    {
+        uint64_t id = mNextId++;
+        mPrograms.push_back({ id, program });
+        return id;
+    }
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        return push_programs(mPrograms, mNextId, programs, count);
+    }
+
+    // A program that ends before its limit frees processors the reservations were planned around.
+    void on_finish(const running_program& program, uint64_t tick)
+    {
+        if (!mValid)
+        {
+            return;
+        }
+
+        mFree += program.processors;
+        --mRunning;
+        if (program.tickEnd < program.tickLimit)
+        {
+            if (!mStale)
+            {
+                mProfile.advance(tick);
+                mProfile.release(tick, program.tickLimit - tick, program.processors);
+            }
+            mCompress = true;
+        }
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& p : mPrograms)
+        {
+            f(p);
+        }
+    }
+
+    // The profile isn't saved: the first get() after load() rebuilds it from the state and the
+    // reservations, which gives the same steps the running queue had.
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        mPrograms.save(writer);
+
+        writer.write(mValid);
+        writer.write(mCompress);
+        writer.write(mTick);
+        writer.write(mFree);
+        writer.write(mRunning);
+        writer.write(mCapacity);
+        writer.write<uint64_t>(mPlanned);
+        auto iter = mPrograms.begin();
+        for (size_t i = 0; i < mPlanned; ++i, ++iter)
+        {
+            writer.write(mStarts.at((*iter).first));
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        mPrograms.load(reader);
+
+        reader.read(mValid);
+        reader.read(mCompress);
+        reader.read(mTick);
+        reader.read(mFree);
+        reader.read(mRunning);
+        reader.read(mCapacity);
+        const uint64_t planned = reader.read<uint64_t>();
+        if (planned > mPrograms.size())
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+        }
+
+        mPlanned = (size_t)planned;
+        mStarts.clear();
+        mDue.clear();
+        auto iter = mPrograms.begin();
+        for (size_t i = 0; i < mPlanned; ++i, ++iter)
+        {
+            mStarts[(*iter).first] = reader.read<uint64_t>();
+        }
+        mStale = mValid;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,308 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "binary_io.h"
+
+// Queue storage whose copies share fixed-size chunks. A chunk is cloned only when a copy
+// writes into it, so forking a queue costs one pointer per chunk.
+template<typename T>
+class cow_deque
+{
+private:
+    static constexpr size_t chunk_size = 256;
+
+    using chunk = std::vector<T>;
+
+    struct segment
+    {
+        std::shared_ptr<chunk> data;
+        size_t begin;
+        size_t end;
+        mutable bool owned;
+    };
+
+    std::deque<segment> mSegments;
+    size_t mSize;
+
+    // Shared chunks are never modified, so a private copy of the visible range is enough.
+    // Like cow_vector, a chunk is cloned even if the other copies have already released it.
+    void make_owned(segment& s)
+    {
+        if (s.owned)
+        {
+            return;
+        }
+
+        std::shared_ptr<chunk> data = std::make_shared<chunk>();
+        data->reserve(chunk_size);
+        data->assign(s.data->begin() + s.begin, s.data->begin() + s.end);
+        s.data = std::move(data);
+        s.end -= s.begin;
+        s.begin = 0;
+        s.owned = true;
+    }
+
+    void disown() const noexcept
+    {
+        for (const segment& s : mSegments)
+        {
+            s.owned = false;
+        }
+    }
+
+public:
+    struct iterator
+    {
+    private:
+        const cow_deque* mDeque;
+        size_t mSegment;
+        size_t mOffset;
+        // The current segment's elements and end, so stepping and dereferencing don't go through the deque.
+        const T* mData;
+        size_t mEnd;
+
+        iterator(const cow_deque* deque, size_t segment, size_t offset) noexcept
+            : mDeque(deque), mSegment(segment), mOffset(offset)
+        {
+            load_segment();
+        }
+
+        void load_segment() noexcept
+        {
+            if (mSegment < mDeque->mSegments.size())
+            {
+                mData = mDeque->mSegments[mSegment].data->data();
+                mEnd = mDeque->mSegments[mSegment].end;
+            } else
+            {
+                mData = nullptr;
+                mEnd = 0;
+            }
+        }
+    public:
+        iterator& operator++()
+        {
+            if (mData == nullptr)
+            {
+                throw std::out_of_range(__FUNCTION__ ": can't increment end() iterator.");
+            }
+
+            if (++mOffset == mEnd)
+            {
+                ++mSegment;
+                load_segment();
+                mOffset = mData != nullptr ? mDeque->mSegments[mSegment].begin : 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return mDeque == other.mDeque && mSegment == other.mSegment && mOffset == other.mOffset;
+        }
+
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        const T& operator*() const
+        {
+            if (mData == nullptr)
+            {
+                throw std::out_of_range(__FUNCTION__ ": can't dereference end() iterator.");
+            }
+
+            return mData[mOffset];
+        }
+
+        friend class cow_deque;
+    };
+
+    cow_deque() : mSize(0) {}
+    cow_deque(const std::initializer_list<T>& elems) : cow_deque()
+    {
+        for (const auto& elem : elems)
+        {
+            push_back(elem);
+        }
+    }
+
+    cow_deque(const cow_deque& other) : mSegments(other.mSegments), mSize(other.mSize)
+    {
+        disown();
+        other.disown();
+    }
+
+    cow_deque(cow_deque&& other) noexcept : mSegments(std::move(other.mSegments)), mSize(other.mSize)
+    {
+        other.mSegments.clear();
+        other.mSize = 0;
+    }
+
+    cow_deque& operator=(const cow_deque& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        mSegments = other.mSegments;
+        mSize = other.mSize;
+        disown();
+        other.disown();
+        return *this;
+    }
+
+    cow_deque& operator=(cow_deque&& other) noexcept
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        mSegments = std::move(other.mSegments);
+        mSize = other.mSize;
+        other.mSegments.clear();
+        other.mSize = 0;
+        return *this;
+    }
+
+    size_t size() const noexcept { return mSize; }
+    bool is_empty() const noexcept { return size() == 0; }
+
+    void push_back(const T& elem)
+    {
+        if (mSegments.empty() || mSegments.back().end == chunk_size)
+        {
+            std::shared_ptr<chunk> data = std::make_shared<chunk>();
+            data->reserve(chunk_size);
+            mSegments.push_back({ std::move(data), 0, 0, true });
+        }
+
+        segment& s = mSegments.back();
+        make_owned(s);
+        s.data->push_back(elem);
+        ++s.end;
+        ++mSize;
+    }
+
+    void pop_front()
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't pop front element of empty deque.");
+        }
+
+        if (++mSegments.front().begin == mSegments.front().end)
+        {
+            mSegments.pop_front();
+        }
+        --mSize;
+    }
+
+    void pop_back()
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't pop back element from empty deque.");
+        }
+
+        segment& s = mSegments.back();
+        --s.end;
+        if (s.owned)
+        {
+            s.data->pop_back();
+        }
+        if (s.begin == s.end)
+        {
+            mSegments.pop_back();
+        }
+        --mSize;
+    }
+
+    void clear()
+    {
+        mSegments.clear();
+        mSize = 0;
+    }
+
+    const T& back() const
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't get back from empty deque.");
+        }
+
+        return (*mSegments.back().data)[mSegments.back().end - 1];
+    }
+
+    const T& front() const
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't get front from empty deque.");
+        }
+
+        return (*mSegments.front().data)[mSegments.front().begin];
+    }
+
+    void erase(const iterator& pos)
+    {
+        if (pos.mDeque != this || pos.mSegment >= mSegments.size())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't erase after end of deque.");
+        }
+
+        segment& s = mSegments[pos.mSegment];
+        const size_t offset = pos.mOffset - s.begin;
+        make_owned(s);
+        s.data->erase(s.data->begin() + s.begin + offset);
+        --s.end;
+        if (s.begin == s.end)
+        {
+            mSegments.erase(mSegments.begin() + pos.mSegment);
+        }
+        --mSize;
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write<uint64_t>(mSize);
+        for (const auto& elem : *this)
+        {
+            writer.write(elem);
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        clear();
+        const uint64_t size = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            T elem;
+            reader.read(elem);
+            push_back(elem);
+        }
+    }
+
+    iterator begin() const noexcept
+    {
+        return mSegments.empty() ? end() : iterator(this, 0, mSegments.front().begin);
+    }
+
+    iterator end() const noexcept { return iterator(this, mSegments.size(), 0); }
+};
\ No newline at end of file
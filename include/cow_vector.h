@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "binary_io.h"
+
+// Fixed-size chunks are shared between copies and cloned on the first write,
+// so copying costs one pointer per chunk instead of one element per element.
+template<typename T>
+class cow_vector
+{
+private:
+    static constexpr size_t chunk_bits = 10;
+    static constexpr size_t chunk_size = size_t(1) << chunk_bits;
+
+    using chunk = std::vector<T>;
+
+    std::vector<std::shared_ptr<chunk>> mChunks;
+    mutable std::vector<unsigned char> mOwned;
+    size_t mSize;
+
+    // A chunk that was ever shared is cloned even if the other copies have released it since:
+    // use_count() gives no ordering guarantees, so writing in place could race with their reads.
+    void make_owned(size_t c)
+    {
+        mChunks[c] = std::make_shared<chunk>(*mChunks[c]);
+        mOwned[c] = 1;
+    }
+
+public:
+    cow_vector() : mSize(0) {}
+
+    explicit cow_vector(size_t size, const T& value = T()) : mSize(0)
+    {
+        resize(size, value);
+    }
+
+    cow_vector(const std::vector<T>& values) : mSize(0)
+    {
+        resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            (*this)[i] = values[i];
+        }
+    }
+
+    cow_vector(const cow_vector& other) : mChunks(other.mChunks), mOwned(other.mChunks.size(), 0), mSize(other.mSize)
+    {
+        other.mOwned.assign(other.mChunks.size(), 0);
+    }
+
+    cow_vector(cow_vector&& other) noexcept = default;
+
+    cow_vector& operator=(const cow_vector& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        mChunks = other.mChunks;
+        mOwned.assign(mChunks.size(), 0);
+        other.mOwned.assign(mChunks.size(), 0);
+        mSize = other.mSize;
+        return *this;
+    }
+
+    cow_vector& operator=(cow_vector&& other) noexcept = default;
+
+    size_t size() const noexcept { return mSize; }
+    bool empty() const noexcept { return mSize == 0; }
+
+    const T& operator[](size_t index) const
+    {
+        return (*mChunks[index >> chunk_bits])[index & (chunk_size - 1)];
+    }
+
+    T& operator[](size_t index)
+    {
+        const size_t c = index >> chunk_bits;
+        if (!mOwned[c])
+        {
+            make_owned(c);
+        }
+        return (*mChunks[c])[index & (chunk_size - 1)];
+    }
+
+    void resize(size_t size, const T& value = T())
+    {
+        if (size < mSize)
+        {
+            mChunks.resize((size + chunk_size - 1) >> chunk_bits);
+            mOwned.resize(mChunks.size());
+            mSize = size;
+            return;
+        }
+
+        while (mSize < size)
+        {
+            const size_t c = mSize >> chunk_bits;
+            if (c == mChunks.size())
+            {
+                mChunks.push_back(std::make_shared<chunk>(chunk_size, value));
+                mOwned.push_back(1);
+                mSize = mSize + chunk_size < size ? mSize + chunk_size : size;
+            } else
+            {
+                (*this)[mSize] = value;
+                ++mSize;
+            }
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements can be saved");
+        writer.write<uint64_t>(mSize);
+        for (size_t c = 0; c < mChunks.size(); ++c)
+        {
+            const size_t count = c + 1 < mChunks.size() ? chunk_size : mSize - c * chunk_size;
+            writer.write_bytes(mChunks[c]->data(), count * sizeof(T));
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        std::vector<T> values;
+        reader.read(values);
+        *this = cow_vector(values);
+    }
+};
\ No newline at end of file
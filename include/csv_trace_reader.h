@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "mapped_file.h"
+#include "trace_job.h"
+
+class csv_trace_reader
+{
+private:
+    std::optional<mapped_file> mFile;
+    const char* mCurrent;
+    const char* mEnd;
+    uint64_t mLine;
+
+    void parse_line(const char* begin, const char* end, trace_job& job);
+
+public:
+    csv_trace_reader(const std::string& path);
+    csv_trace_reader(const char* data, size_t size);
+
+    bool next(trace_job& job);
+
+    uint64_t line() const noexcept { return mLine; }
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <optional>
+#include <cstdint>
+#include "linked_list.h"
+#include "program_info.h"
+#include "queue_traits.h"
+#include "cluster_state.h"
+
+template<uint64_t LookAhead = UINT64_MAX, template<typename> class Storage = linked_list>
+class easy_backfill_queue
+{
+private:
+    uint64_t mNextId;
+    uint64_t mLookAhead;
+    Storage<std::pair<uint64_t, program_info>> mPrograms;
+public:
+    easy_backfill_queue(uint64_t lookAhead = LookAhead) : mNextId(0), mLookAhead(lookAhead) {}
+
+    std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
+    {
+        if (mPrograms.size() == 0)
+        {
+            return std::nullopt;
+        }
+
+        const program_info head = mPrograms.front().second;
+        if (state.freeProcessors >= head.processors)
+        {
+            std::pair<uint64_t, program_info> p = mPrograms.front();
+            mPrograms.pop_front();
+            return p;
+        }
+
+        // Without reservations the free processors only grow as running programs end, so the head
+        // starts at the first release that frees enough of them. The completion profile is kept up to
+        // date on every start and early finish, so no profile has to be built here.
+        uint64_t shadowTick = UINT64_MAX;
+        uint64_t available = state.freeProcessors;
+        for (const auto& release : state.completions)
+        {
+            const uint64_t tick = release.first > state.currentTick ? release.first : state.currentTick + 1;
+            if (shadowTick != UINT64_MAX && tick != shadowTick)
+            {
+                break;
+            }
+
+            available += release.second;
+            if (shadowTick == UINT64_MAX && available >= head.processors)
+            {
+                shadowTick = tick;
+            }
+        }
+        const uint64_t extraProcessors = shadowTick == UINT64_MAX ? 0 : available - head.processors;
+
+        uint64_t lookAhead = mLookAhead;
+        auto iter = mPrograms.begin();
+        for (++iter; iter != mPrograms.end() && lookAhead > 0; ++iter, --lookAhead)
+        {
+            const auto& p = *iter;
+            if (p.second.processors > state.freeProcessors)
+            {
+                continue;
+            }
+
+            const uint64_t duration = p.second.occupied_ticks();
+            if (duration <= shadowTick - state.currentTick || p.second.processors <= extraProcessors)
+            {
+                std::pair<uint64_t, program_info> tmp = p;
+                mPrograms.erase(iter);
+                return tmp;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    uint64_t push(const program_info& program, uint64_t tick)
+    {
+        uint64_t id = mNextId++;
+        mPrograms.push_back({ id, program });
+        return id;
+    }
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        return push_programs(mPrograms, mNextId, programs, count);
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& p : mPrograms)
+        {
+            f(p);
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        mPrograms.save(writer);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        mPrograms.load(reader);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,236 @@
+#pragma once
+#include <optional>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "indexed_heap.h"
+#include "program_info.h"
+#include "running_program.h"
+#include "cluster_state.h"
+#include "binary_io.h"
+
+// Starts the oldest program of the user with the least decayed usage; a head that doesn't fit blocks.
+// Usage is the processor-ticks of finished programs, halved every HalfLife ticks. A user's usage at
+// tick t is 2^(key - t / halfLife), where key only changes when the user is charged, so decay alone
+// never reorders the users and a completion costs one heap update.
+template<uint64_t HalfLife = 1000>
+class fair_share_queue
+{
+private:
+    struct user_record
+    {
+        uint64_t userId;
+        double usageKey;
+        std::deque<std::pair<uint64_t, program_info>> programs;
+    };
+
+    static constexpr double no_usage = -std::numeric_limits<double>::infinity();
+
+    uint64_t mNextId;
+    uint64_t mHalfLife;
+    size_t mSize;
+    std::vector<user_record> mUsers;
+    std::unordered_map<uint64_t, uint32_t> mUserIndex;
+    indexed_heap<std::pair<double, uint64_t>> mHeap;
+
+    uint32_t user_handle(uint64_t userId)
+    {
+        auto it = mUserIndex.find(userId);
+        if (it != mUserIndex.end())
+        {
+            return it->second;
+        }
+
+        if (mUsers.size() >= UINT32_MAX)
+        {
+            throw std::length_error(__FUNCTION__ ": too many users.");
+        }
+
+        const uint32_t handle = (uint32_t)mUsers.size();
+        mUsers.push_back({ userId, no_usage, {} });
+        mUserIndex.emplace(userId, handle);
+        return handle;
+    }
+
+    std::pair<double, uint64_t> heap_key(uint32_t handle) const
+    {
+        return { mUsers[handle].usageKey, mUsers[handle].programs.front().first };
+    }
+
+    double decay_ticks(uint64_t tick) const
+    {
+        return (double)tick / (double)mHalfLife;
+    }
+
+    void insert(const std::pair<uint64_t, program_info>& program)
+    {
+        const uint32_t handle = user_handle(program.second.userId);
+        mUsers[handle].programs.push_back(program);
+        if (!mHeap.contains(handle))
+        {
+            mHeap.push(handle, heap_key(handle));
+        }
+        ++mSize;
+    }
+
+public:
+    fair_share_queue(uint64_t halfLife = HalfLife) : mNextId(0), mHalfLife(halfLife), mSize(0)
+    {
+        if (halfLife < 1)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": half-life must be positive.");
+        }
+    }
+
+    std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
+    {
+        if (mHeap.is_empty())
+        {
+            return std::nullopt;
+        }
+
+        const uint32_t handle = mHeap.top();
+        user_record& user = mUsers[handle];
+        if (user.programs.front().second.processors > state.freeProcessors)
+        {
+            return std::nullopt;
+        }
+
+        std::pair<uint64_t, program_info> res = user.programs.front();
+        user.programs.pop_front();
+        --mSize;
+        if (user.programs.empty())
+        {
+            mHeap.pop();
+        } else
+        {
+            mHeap.update(handle, heap_key(handle));
+        }
+        return res;
+    }
+
+    uint64_t push(const program_info& program, uint64_t tick)
+    {
+        uint64_t id = mNextId++;
+        insert({ id, program });
+        return id;
+    }
+
+    // Charges the program's processor-ticks to its user.
+    void on_finish(const running_program& program, uint64_t tick)
+    {
+        const uint64_t processorTicks = program.processors * (program.tickEnd - program.tickStart);
+        if (processorTicks == 0)
+        {
+            return;
+        }
+
+        const uint32_t handle = user_handle(program.userId);
+        const double now = decay_ticks(tick);
+        user_record& user = mUsers[handle];
+        user.usageKey = now + std::log2(std::exp2(user.usageKey - now) + (double)processorTicks);
+        if (mHeap.contains(handle))
+        {
+            mHeap.update(handle, heap_key(handle));
+        }
+    }
+
+    double usage(uint64_t userId, uint64_t tick) const
+    {
+        auto it = mUserIndex.find(userId);
+        return it == mUserIndex.end() ? 0.0 : std::exp2(mUsers[it->second].usageKey - decay_ticks(tick));
+    }
+
+    size_t size() const noexcept { return mSize; }
+
+    // Visits the programs user by user; callers that need submission order sort by id.
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const user_record& user : mUsers)
+        {
+            for (const auto& program : user.programs)
+            {
+                f(program);
+            }
+        }
+    }
+
+    // Streams the users in handle order with their queues, then the heap array, so load() rebuilds
+    // the same handles and the same heap.
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        writer.write<uint64_t>(mUsers.size());
+        for (const user_record& user : mUsers)
+        {
+            writer.write(user.userId);
+            writer.write(user.usageKey);
+            writer.write<uint64_t>(user.programs.size());
+            for (const auto& program : user.programs)
+            {
+                writer.write(program);
+            }
+        }
+
+        writer.write<uint64_t>(mHeap.size());
+        mHeap.for_each([&](uint32_t handle, const std::pair<double, uint64_t>&) { writer.write(handle); });
+    }
+
+    void load(binary_reader& reader)
+    {
+        mUsers.clear();
+        mUserIndex.clear();
+        mHeap.clear();
+        mSize = 0;
+
+        reader.read(mNextId);
+        const uint64_t users = reader.read<uint64_t>();
+        size_t waitingUsers = 0;
+        for (uint64_t i = 0; i < users; ++i)
+        {
+            const uint64_t userId = reader.read<uint64_t>();
+            if (mUserIndex.count(userId) != 0)
+            {
+                throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+            }
+
+            user_record& user = mUsers[user_handle(userId)];
+            reader.read(user.usageKey);
+            const uint64_t programs = reader.read<uint64_t>();
+            for (uint64_t j = 0; j < programs; ++j)
+            {
+                std::pair<uint64_t, program_info> program;
+                reader.read(program);
+                if (program.first >= mNextId || program.second.userId != userId)
+                {
+                    throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+                }
+                user.programs.push_back(program);
+            }
+            mSize += user.programs.size();
+            waitingUsers += user.programs.empty() ? 0 : 1;
+        }
+
+        const uint64_t heapSize = reader.read<uint64_t>();
+        if (heapSize != waitingUsers)
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+        }
+
+        for (uint64_t i = 0; i < heapSize; ++i)
+        {
+            const uint32_t handle = reader.read<uint32_t>();
+            if (handle >= mUsers.size() || mUsers[handle].programs.empty() || mHeap.contains(handle))
+            {
+                throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+            }
+            mHeap.push(handle, heap_key(handle));
+        }
+    }
+};
\ No newline at end of file
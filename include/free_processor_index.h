@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include "binary_io.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class free_processor_index
+{
+private:
+    std::vector<uint64_t> mWords;
+    uint64_t mSize;
+    uint64_t mFree;
+    uint64_t mFirstWord;
+
+    static uint64_t count_trailing_zeros(uint64_t word) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return index;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+public:
+    free_processor_index(uint64_t size = 0)
+        : mWords((size + 63) / 64, UINT64_MAX), mSize(size), mFree(size), mFirstWord(0)
+    {
+        if (size % 64 != 0)
+        {
+            mWords.back() = (1ULL << (size % 64)) - 1;
+        }
+    }
+
+    uint64_t size() const noexcept { return mSize; }
+    uint64_t free_count() const noexcept { return mFree; }
+
+    bool is_free(uint64_t processor) const
+    {
+        if (processor >= mSize)
+        {
+            throw std::out_of_range(__FUNCTION__ ": processor index is out of range.");
+        }
+
+        return (mWords[processor / 64] >> (processor % 64)) & 1;
+    }
+
+    template<typename F>
+    void acquire(uint64_t count, F&& onAcquired)
+    {
+        if (count > mFree)
+        {
+            throw std::out_of_range(__FUNCTION__ ": not enough free processors.");
+        }
+
+        mFree -= count;
+        for (uint64_t w = mFirstWord; count > 0; ++w)
+        {
+            uint64_t& word = mWords[w];
+            while (word != 0 && count > 0)
+            {
+                uint64_t bit = count_trailing_zeros(word);
+                word &= word - 1;
+                --count;
+                onAcquired(w * 64 + bit);
+            }
+
+            if (word == 0 && w == mFirstWord)
+            {
+                ++mFirstWord;
+            }
+        }
+    }
+
+    // Acquires free processors from [first, last) only; the range must have enough of them.
+    template<typename F>
+    void acquire_range(uint64_t first, uint64_t last, uint64_t count, F&& onAcquired)
+    {
+        if (first > last || last > mSize)
+        {
+            throw std::out_of_range(__FUNCTION__ ": processor range is out of range.");
+        }
+
+        const uint64_t firstWord = first / 64 > mFirstWord ? first / 64 : mFirstWord;
+        for (uint64_t w = firstWord; count > 0 && w * 64 < last; ++w)
+        {
+            const uint64_t lo = first > w * 64 ? first - w * 64 : 0;
+            const uint64_t hi = last < (w + 1) * 64 ? last - w * 64 : 64;
+            const uint64_t mask = (hi == 64 ? UINT64_MAX : (1ULL << hi) - 1) & ~((1ULL << lo) - 1);
+
+            uint64_t& word = mWords[w];
+            uint64_t candidates = word & mask;
+            while (candidates != 0 && count > 0)
+            {
+                uint64_t bit = count_trailing_zeros(candidates);
+                candidates &= candidates - 1;
+                word &= ~(1ULL << bit);
+                --count;
+                --mFree;
+                onAcquired(w * 64 + bit);
+            }
+
+            if (word == 0 && w == mFirstWord)
+            {
+                ++mFirstWord;
+            }
+        }
+
+        if (count > 0)
+        {
+            throw std::out_of_range(__FUNCTION__ ": not enough free processors in range.");
+        }
+    }
+
+    void grow(uint64_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        const uint64_t oldSize = mSize;
+        mSize += count;
+        mFree += count;
+        mWords.resize((mSize + 63) / 64, 0);
+        for (uint64_t w = oldSize / 64; w < mWords.size(); ++w)
+        {
+            const uint64_t from = w * 64 > oldSize ? w * 64 : oldSize;
+            const uint64_t to = (w + 1) * 64 < mSize ? (w + 1) * 64 : mSize;
+            const uint64_t bits = to - from == 64 ? UINT64_MAX : ((1ULL << (to - from)) - 1);
+            mWords[w] |= bits << (from % 64);
+        }
+
+        if (oldSize / 64 < mFirstWord)
+        {
+            mFirstWord = oldSize / 64;
+        }
+    }
+
+    void release(uint64_t processor)
+    {
+        if (is_free(processor))
+        {
+            throw std::logic_error(__FUNCTION__ ": processor is already free.");
+        }
+
+        mWords[processor / 64] |= 1ULL << (processor % 64);
+        if (processor / 64 < mFirstWord)
+        {
+            mFirstWord = processor / 64;
+        }
+        ++mFree;
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mSize);
+        writer.write(mFree);
+        writer.write(mFirstWord);
+        writer.write(mWords);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mSize);
+        reader.read(mFree);
+        reader.read(mFirstWord);
+        reader.read(mWords);
+        if (mWords.size() != (mSize + 63) / 64 || mFree > mSize || mFirstWord > mWords.size())
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted processor index snapshot.");
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+#include <optional>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "indexed_heap.h"
+#include "program_info.h"
+#include "cluster_state.h"
+#include "binary_io.h"
+
+// Orders for heap_queue; programs with smaller priority start first.
+struct shortest_job_first
+{
+    static double priority(const program_info& program) noexcept { return (double)program.executionTime; }
+};
+
+struct longest_job_first
+{
+    static double priority(const program_info& program) noexcept { return -(double)program.executionTime; }
+};
+
+struct smallest_area_first
+{
+    static double priority(const program_info& program) noexcept { return (double)program.processors * (double)program.executionTime; }
+};
+
+struct widest_first
+{
+    static double priority(const program_info& program) noexcept { return -(double)program.processors; }
+};
+
+// Starts programs strictly in Order, ties in submission order. Every tick of waiting takes aging
+// off a program's priority: priority - aging * (now - submitted). All programs age at the same rate,
+// so ordering by priority + aging * submitted is equivalent and the heap never has to be reordered.
+template<typename Order, uint64_t Aging = 0>
+class heap_queue
+{
+private:
+    struct program_record
+    {
+        uint64_t programId;
+        uint64_t tickAdded;
+        program_info info;
+    };
+
+    uint64_t mNextId;
+    uint64_t mAging;
+    std::vector<program_record> mRecords;
+    std::vector<uint32_t> mFreeSlots;
+    indexed_heap<std::pair<double, uint64_t>> mHeap;
+
+    void insert(const program_record& record)
+    {
+        uint32_t slot;
+        if (!mFreeSlots.empty())
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+            mRecords[slot] = record;
+        } else
+        {
+            if (mRecords.size() >= UINT32_MAX)
+            {
+                throw std::length_error(__FUNCTION__ ": too many queued programs.");
+            }
+
+            slot = (uint32_t)mRecords.size();
+            mRecords.push_back(record);
+        }
+
+        mHeap.push(slot, { Order::priority(record.info) + (double)mAging * (double)record.tickAdded, record.programId });
+    }
+
+public:
+    heap_queue(uint64_t aging = Aging) : mNextId(0), mAging(aging) {}
+
+    std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
+    {
+        if (mHeap.is_empty())
+        {
+            return std::nullopt;
+        }
+
+        const uint32_t slot = mHeap.top();
+        if (mRecords[slot].info.processors > state.freeProcessors)
+        {
+            return std::nullopt;
+        }
+
+        mHeap.pop();
+        mFreeSlots.push_back(slot);
+        return std::pair<uint64_t, program_info>{ mRecords[slot].programId, mRecords[slot].info };
+    }
+
+    uint64_t push(const program_info& program, uint64_t tick)
+    {
+        uint64_t id = mNextId++;
+        insert({ id, tick, program });
+        return id;
+    }
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        uint64_t firstId = mNextId;
+        mRecords.reserve(mRecords.size() + count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            push(programs[i], tick);
+        }
+        return firstId;
+    }
+
+    size_t size() const noexcept { return mHeap.size(); }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (uint32_t slot = 0; slot < mRecords.size(); ++slot)
+        {
+            if (mHeap.contains(slot))
+            {
+                f(std::pair<uint64_t, program_info>{ mRecords[slot].programId, mRecords[slot].info });
+            }
+        }
+    }
+
+    // Streamed in heap order. Keys are unique, so the heap array doesn't depend on the slot layout
+    // and equal queues give equal snapshots.
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        writer.write<uint64_t>(mHeap.size());
+        mHeap.for_each([&](uint32_t slot, const std::pair<double, uint64_t>&) { writer.write(mRecords[slot]); });
+    }
+
+    // Records read in heap order are pushed without moving; any other order is simply heapified.
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        const uint64_t size = reader.read<uint64_t>();
+
+        mRecords.clear();
+        mFreeSlots.clear();
+        mHeap.clear();
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            program_record record;
+            reader.read(record);
+            if (record.programId >= mNextId)
+            {
+                throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+            }
+            insert(record);
+        }
+    }
+};
+
+template<uint64_t Aging = 0>
+using sjf_queue = heap_queue<shortest_job_first, Aging>;
+
+template<uint64_t Aging = 0>
+using ljf_queue = heap_queue<longest_job_first, Aging>;
+
+template<uint64_t Aging = 0>
+using smallest_area_queue = heap_queue<smallest_area_first, Aging>;
+
+template<uint64_t Aging = 0>
+using widest_first_queue = heap_queue<widest_first, Aging>;
\ No newline at end of file
@@ -0,0 +1,205 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+
+// Binary min-heap over small integer handles. The heap remembers where every handle is,
+// so keys can be changed or handles removed in O(log n) without searching for them.
+template<typename Key, typename Compare = std::less<Key>>
+class indexed_heap
+{
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    std::vector<std::pair<Key, uint32_t>> mHeap;
+    std::vector<uint32_t> mPosition;
+    Compare mCompare;
+
+    bool less(size_t a, size_t b) const
+    {
+        return mCompare(mHeap[a].first, mHeap[b].first);
+    }
+
+    void place(size_t i)
+    {
+        mPosition[mHeap[i].second] = (uint32_t)i;
+    }
+
+    void sift_up(size_t i)
+    {
+        while (i > 0 && less(i, (i - 1) / 2))
+        {
+            std::swap(mHeap[i], mHeap[(i - 1) / 2]);
+            place(i);
+            i = (i - 1) / 2;
+        }
+        place(i);
+    }
+
+    void sift_down(size_t i)
+    {
+        for (;;)
+        {
+            size_t smallest = i;
+            const size_t left = 2 * i + 1;
+            if (left < mHeap.size() && less(left, smallest))
+            {
+                smallest = left;
+            }
+            if (left + 1 < mHeap.size() && less(left + 1, smallest))
+            {
+                smallest = left + 1;
+            }
+            if (smallest == i)
+            {
+                break;
+            }
+
+            std::swap(mHeap[i], mHeap[smallest]);
+            place(i);
+            i = smallest;
+        }
+        place(i);
+    }
+
+    void remove_at(size_t i)
+    {
+        mPosition[mHeap[i].second] = npos;
+        if (i + 1 == mHeap.size())
+        {
+            mHeap.pop_back();
+            return;
+        }
+
+        mHeap[i] = std::move(mHeap.back());
+        mHeap.pop_back();
+        place(i);
+        if (i > 0 && less(i, (i - 1) / 2))
+        {
+            sift_up(i);
+        } else
+        {
+            sift_down(i);
+        }
+    }
+
+public:
+    indexed_heap(const Compare& compare = Compare()) : mCompare(compare) {}
+
+    size_t size() const noexcept { return mHeap.size(); }
+    bool is_empty() const noexcept { return mHeap.empty(); }
+
+    bool contains(uint32_t handle) const noexcept
+    {
+        return handle < mPosition.size() && mPosition[handle] != npos;
+    }
+
+    void push(uint32_t handle, const Key& key)
+    {
+        if (handle == npos)
+        {
+            throw std::out_of_range(__FUNCTION__ ": handle is out of range.");
+        }
+
+        if (contains(handle))
+        {
+            throw std::logic_error(__FUNCTION__ ": handle is already in the heap.");
+        }
+
+        if (handle >= mPosition.size())
+        {
+            mPosition.resize((size_t)handle + 1, npos);
+        }
+
+        mHeap.push_back({ key, handle });
+        sift_up(mHeap.size() - 1);
+    }
+
+    uint32_t top() const
+    {
+        if (mHeap.empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": heap is empty.");
+        }
+
+        return mHeap.front().second;
+    }
+
+    const Key& top_key() const
+    {
+        if (mHeap.empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": heap is empty.");
+        }
+
+        return mHeap.front().first;
+    }
+
+    void pop()
+    {
+        if (mHeap.empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": heap is empty.");
+        }
+
+        remove_at(0);
+    }
+
+    const Key& key(uint32_t handle) const
+    {
+        if (!contains(handle))
+        {
+            throw std::out_of_range(__FUNCTION__ ": handle is not in the heap.");
+        }
+
+        return mHeap[mPosition[handle]].first;
+    }
+
+    void update(uint32_t handle, const Key& key)
+    {
+        if (!contains(handle))
+        {
+            throw std::out_of_range(__FUNCTION__ ": handle is not in the heap.");
+        }
+
+        const size_t i = mPosition[handle];
+        const bool decreased = mCompare(key, mHeap[i].first);
+        mHeap[i].first = key;
+        if (decreased)
+        {
+            sift_up(i);
+        } else
+        {
+            sift_down(i);
+        }
+    }
+
+    void erase(uint32_t handle)
+    {
+        if (!contains(handle))
+        {
+            throw std::out_of_range(__FUNCTION__ ": handle is not in the heap.");
+        }
+
+        remove_at(mPosition[handle]);
+    }
+
+    void clear() noexcept
+    {
+        mHeap.clear();
+        mPosition.clear();
+    }
+
+    // Visits (handle, key) in array order. Pushing them back in that order rebuilds the same heap
+    // without a single swap.
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& entry : mHeap)
+        {
+            f(entry.second, entry.first);
+        }
+    }
+};
\ No newline at end of file
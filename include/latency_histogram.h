@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "binary_io.h"
+
+struct latency_summary
+{
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+class latency_histogram
+{
+private:
+    static const uint64_t sub_bucket_bits = 7;
+    static const uint64_t sub_bucket_count = uint64_t(1) << sub_bucket_bits;
+
+    std::vector<uint64_t> mCounts;
+    uint64_t mCount;
+    uint64_t mMax;
+    double mSum;
+
+    static size_t bucket_index(uint64_t value) noexcept;
+    static uint64_t bucket_highest_value(size_t index) noexcept;
+
+public:
+    latency_histogram() : mCount(0), mMax(0), mSum(0) {}
+
+    void record(uint64_t value);
+    void merge(const latency_histogram& other);
+
+    uint64_t value_at_quantile(double quantile) const;
+
+    latency_summary summary(double scale = 1.0) const;
+
+    void save(binary_writer& writer) const;
+    void load(binary_reader& reader);
+
+    uint64_t count() const noexcept { return mCount; }
+    uint64_t max() const noexcept { return mMax; }
+    double mean() const noexcept { return mCount > 0 ? mSum / mCount : 0.0; }
+};
\ No newline at end of file
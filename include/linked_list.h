@@ -1,6 +1,9 @@
 #pragma once
 #include <initializer_list>
 #include <stdexcept>
+#include <vector>
+#include <new>
+#include "binary_io.h"
 
 template<typename T>
 class linked_list
@@ -13,10 +16,95 @@ private:
         node* next;
     };
 
+    struct free_node
+    {
+        free_node* next;
+    };
+
+    static constexpr size_t first_slab_nodes = 16;
+    static constexpr size_t max_slab_nodes = 4096;
+
     node* mFirst;
     node* mLast;
     size_t mSize;
 
+    std::vector<void*> mSlabs;
+    free_node* mFreeNodes;
+    size_t mFreeCount;
+    size_t mSlabNodes;
+
+    void add_slab(size_t nodes)
+    {
+        void* slab = ::operator new(sizeof(node) * nodes);
+        mSlabs.push_back(slab);
+
+        unsigned char* storage = static_cast<unsigned char*>(slab);
+        for (size_t i = nodes; i > 0; --i)
+        {
+            mFreeNodes = new (storage + (i - 1) * sizeof(node)) free_node{ mFreeNodes };
+        }
+        mFreeCount += nodes;
+    }
+
+    // Slabs grow geometrically up to max_slab_nodes; a larger request gets one slab of its own.
+    void grow(size_t nodes)
+    {
+        add_slab(nodes > mSlabNodes ? nodes : mSlabNodes);
+        if (mSlabNodes < max_slab_nodes)
+        {
+            mSlabNodes *= 2;
+        }
+    }
+
+    node* create_node(const T& data, node* prev, node* next)
+    {
+        if (mFreeNodes == nullptr)
+        {
+            grow(1);
+        }
+
+        free_node* storage = mFreeNodes;
+        mFreeNodes = storage->next;
+        --mFreeCount;
+        storage->~free_node();
+        return new (storage) node{ data, prev, next };
+    }
+
+    void destroy_node(node* n) noexcept
+    {
+        n->~node();
+        mFreeNodes = new (n) free_node{ mFreeNodes };
+        ++mFreeCount;
+    }
+
+    void release_slabs() noexcept
+    {
+        for (void* slab : mSlabs)
+        {
+            ::operator delete(slab);
+        }
+
+        mSlabs.clear();
+        mFreeNodes = nullptr;
+        mFreeCount = 0;
+        mSlabNodes = first_slab_nodes;
+    }
+
+    void steal_nodes(linked_list& other) noexcept
+    {
+        mFirst = other.mFirst;
+        mLast = other.mLast;
+        mSize = other.mSize;
+        mSlabs.swap(other.mSlabs);
+        std::swap(mFreeNodes, other.mFreeNodes);
+        std::swap(mFreeCount, other.mFreeCount);
+        std::swap(mSlabNodes, other.mSlabNodes);
+
+        other.mFirst = nullptr;
+        other.mLast = nullptr;
+        other.mSize = 0;
+    }
+
 public:
     struct iterator
     {
@@ -41,7 +129,7 @@ public:
 
         iterator operator++(int)
         {
-            Iterator temp = *this;
+            iterator temp = *this;
             ++(*this);
             return temp;
         }
@@ -88,8 +176,8 @@ public:
         friend class linked_list;
     };
 
-    linked_list() : mSize(0), mFirst(nullptr), mLast(nullptr) {}
-    linked_list(const std::initializer_list<T>& elems) : mSize(0), mFirst(nullptr), mLast(nullptr)
+    linked_list() : mFirst(nullptr), mLast(nullptr), mSize(0), mFreeNodes(nullptr), mFreeCount(0), mSlabNodes(first_slab_nodes) {}
+    linked_list(const std::initializer_list<T>& elems) : linked_list()
     {
         for (const auto& elem : elems)
         {
@@ -97,7 +185,7 @@ public:
         }
     }
 
-    linked_list(const linked_list& other) : mSize(0), mFirst(nullptr), mLast(nullptr)
+    linked_list(const linked_list& other) : linked_list()
     {
         for (const auto& elem : other)
         {
@@ -105,21 +193,20 @@ public:
         }
     }
 
-    linked_list(linked_list&& other) noexcept : mSize(other.mSize), mFirst(other.mFirst), mLast(other.mLast)
+    linked_list(linked_list&& other) noexcept : linked_list()
     {
-        other.mSize = 0;
-        other.mFirst = nullptr;
-        other.mLast = nullptr;
+        steal_nodes(other);
     }
 
     ~linked_list()
     {
         clear();
+        release_slabs();
     }
 
     linked_list& operator=(const linked_list& other)
     {
-        if (mFirst == other.mFirst)
+        if (this == &other)
         {
             return *this;
         }
@@ -129,30 +216,41 @@ public:
         {
             push_back(elem);
         }
+
+        return *this;
     }
 
-    linked_list& operator=(linked_list&& other)
+    linked_list& operator=(linked_list&& other) noexcept
     {
-        if (mFirst == other.mFirst)
+        if (this == &other)
         {
             return *this;
         }
 
         clear();
-        mFirst = other.mFirst;
-        mLast = other.mLast;
-        mSize = other.mSize;
-        other.mFirst = nullptr;
-        other.mLast = nullptr;
-        other.mSize = 0;
+        steal_nodes(other);
+        return *this;
     }
 
     size_t size() const noexcept { return mSize; }
     bool is_empty() const noexcept { return size() == 0; }
+    size_t slab_count() const noexcept { return mSlabs.size(); }
+
+    void reserve(size_t count)
+    {
+        if (count > mSize + mFreeCount)
+        {
+            grow(count - mSize - mFreeCount);
+        }
+    }
 
     void push_front(const T& elem)
     {
-        node* nw = new node{ elem, nullptr, mFirst };
+        node* nw = create_node(elem, nullptr, mFirst);
+        if (mFirst != nullptr)
+        {
+            mFirst->prev = nw;
+        }
         mFirst = nw;
         if (mLast == nullptr)
         {
@@ -164,7 +262,7 @@ public:
 
     void push_back(const T& elem)
     {
-        node* nw = new node{ elem, mLast, nullptr };
+        node* nw = create_node(elem, mLast, nullptr);
         if (mLast != nullptr)
         {
             mLast->next = nw;
@@ -187,7 +285,7 @@ public:
 
         if (mFirst == mLast)
         {
-            delete mFirst;
+            destroy_node(mFirst);
             mFirst = nullptr;
             mLast = nullptr;
         } else
@@ -198,7 +296,7 @@ public:
             {
                 mFirst->prev = nullptr;
             }
-            delete tmp;
+            destroy_node(tmp);
         }
 
         --mSize;
@@ -213,7 +311,7 @@ public:
 
         if (mLast == mFirst)
         {
-            delete mLast;
+            destroy_node(mLast);
             mFirst = nullptr;
             mLast = nullptr;
         } else
@@ -221,7 +319,7 @@ public:
             node* tmp = mLast;
             mLast = mLast->prev;
             mLast->next = nullptr;
-            delete tmp;
+            destroy_node(tmp);
         }
 
         --mSize;
@@ -259,8 +357,11 @@ public:
     {
         if (pos.mCurrent != nullptr)
         {
-            node* nw = new node{ data, pos.mPrevious, pos.mCurrent };
-            pos.mPrevious->next = nw;
+            node* nw = create_node(data, pos.mPrevious, pos.mCurrent);
+            if (pos.mPrevious != nullptr)
+            {
+                pos.mPrevious->next = nw;
+            }
             pos.mCurrent->prev = nw;
 
             if (pos.mCurrent == mFirst)
@@ -303,7 +404,28 @@ public:
             }
 
             --mSize;
-            delete pos.mCurrent;
+            destroy_node(pos.mCurrent);
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write<uint64_t>(mSize);
+        for (const auto& elem : *this)
+        {
+            writer.write(elem);
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        clear();
+        const uint64_t size = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            T elem;
+            reader.read(elem);
+            push_back(elem);
         }
     }
 
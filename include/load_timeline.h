@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "binary_io.h"
+
+struct timeline_bucket
+{
+    uint64_t tickStart;
+    uint64_t ticks;
+    uint64_t loadMin;
+    uint64_t loadMax;
+    double loadSum;
+    uint64_t queueMin;
+    uint64_t queueMax;
+    double queueSum;
+
+    double load_mean() const noexcept { return ticks > 0 ? loadSum / ticks : 0.0; }
+    double queue_mean() const noexcept { return ticks > 0 ? queueSum / ticks : 0.0; }
+};
+
+class load_timeline
+{
+private:
+    struct level
+    {
+        uint64_t width;
+        std::vector<timeline_bucket> buckets;
+        size_t head;
+        timeline_bucket current;
+    };
+
+    std::vector<level> mLevels;
+    std::vector<timeline_bucket> mOverview;
+    timeline_bucket mOverviewCurrent;
+    uint64_t mOverviewWidth;
+    size_t mBucketCount;
+    uint64_t mTick;
+
+    void append(level& l, uint64_t load, uint64_t queued, uint64_t ticks);
+    void append_overview(uint64_t load, uint64_t queued, uint64_t ticks);
+    void compact_overview();
+
+public:
+    load_timeline(size_t bucketCount = 512, size_t levels = 3, uint64_t factor = 16);
+
+    void record(uint64_t load, uint64_t queued, uint64_t ticks = 1);
+
+    std::vector<timeline_bucket> buckets(size_t level) const;
+    uint64_t bucket_width(size_t level) const;
+
+    void write_csv(std::ostream& ostr, size_t level) const;
+
+    void save(binary_writer& writer) const;
+    void load(binary_reader& reader);
+
+    size_t level_count() const noexcept { return mLevels.size() + 1; }
+    size_t overview_level() const noexcept { return mLevels.size(); }
+    uint64_t ticks_recorded() const noexcept { return mTick - 1; }
+};
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+class mapped_file
+{
+private:
+    const char* mData;
+    size_t mSize;
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#else
+    int mFile;
+#endif
+
+    void close() noexcept;
+
+public:
+    mapped_file(const std::string& path);
+    mapped_file(const mapped_file&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+
+    const char* data() const noexcept { return mData; }
+    size_t size() const noexcept { return mSize; }
+};
\ No newline at end of file
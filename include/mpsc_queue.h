@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+template<typename T>
+class mpsc_queue
+{
+private:
+    struct node
+    {
+        std::atomic<node*> next;
+        T value;
+
+        node() : next(nullptr), value() {}
+        node(const T& v) : next(nullptr), value(v) {}
+    };
+
+    alignas(64) std::atomic<node*> mHead;
+    alignas(64) node* mTail;
+
+public:
+    mpsc_queue() : mHead(new node()), mTail(mHead.load(std::memory_order_relaxed)) {}
+    mpsc_queue(const mpsc_queue&) = delete;
+
+    ~mpsc_queue()
+    {
+        while (mTail != nullptr)
+        {
+            node* next = mTail->next.load(std::memory_order_relaxed);
+            delete mTail;
+            mTail = next;
+        }
+    }
+
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    // Safe to call from any number of threads at once.
+    void push(const T& value)
+    {
+        node* n = new node(value);
+        node* prev = mHead.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // Only one thread may pop. A push that is still linking its node is not visible yet.
+    bool try_pop(T& value)
+    {
+        node* next = mTail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        value = std::move(next->value);
+        delete mTail;
+        mTail = next;
+        return true;
+    }
+
+    bool is_empty() const noexcept
+    {
+        return mTail->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cluster_statistics.h"
+#include "load_timeline.h"
+#include "program_info.h"
+#include "scheduler_registry.h"
+#include "thread_pool.h"
+
+struct partition_config
+{
+    std::string name;
+    std::string policy;
+    uint64_t processors;
+    bool lends;
+    bool borrows;
+};
+
+// Programs a partition ran for other partitions (lent) and its own programs run elsewhere (borrowed).
+struct partition_usage
+{
+    uint64_t programsLent;
+    uint64_t programsBorrowed;
+    uint64_t processorTicksLent;
+    uint64_t processorTicksBorrowed;
+};
+
+// Several clusters with their own queue policies sharing one clock. Between sync points the
+// partitions don't touch each other, so they are advanced on separate threads. In the middle of
+// every sync tick, after the partitions started what they could and before the tick is accounted,
+// a borrowing partition with waiting programs hands them, in its own queue order, to lending
+// partitions that have nothing waiting and enough idle processors.
+class partitioned_cluster
+{
+private:
+    struct partition
+    {
+        partition_config config;
+        std::unique_ptr<cluster_simulator> simulator;
+        partition_usage usage;
+    };
+
+    std::vector<partition> mPartitions;
+    std::unique_ptr<thread_pool> mPool;
+    uint64_t mSyncInterval;
+    bool mBorrowing;
+    uint64_t mCurrentTick;
+
+    template<typename F>
+    void for_each_partition(F f);
+
+    void run_partitions(uint64_t targetTick);
+    void borrow_processors();
+
+public:
+    // threads <= 1 advances the partitions on the calling thread.
+    partitioned_cluster(const std::vector<partition_config>& partitions,
+        const scheduler_registry& registry = default_scheduler_registry(),
+        size_t threads = 1, uint64_t syncInterval = 1, bool borrowing = true);
+
+    size_t partition_count() const noexcept { return mPartitions.size(); }
+    size_t partition_index(const std::string& name) const;
+    const partition_config& config(size_t partition) const { return mPartitions.at(partition).config; }
+    const partition_usage& usage(size_t partition) const { return mPartitions.at(partition).usage; }
+
+    void add_program(size_t partition, const program_info& info);
+    void add_programs(size_t partition, const program_info* programs, size_t count);
+
+    template<typename Container>
+    void add_programs(size_t partition, const Container& programs)
+    {
+        add_programs(partition, programs.data(), programs.size());
+    }
+
+    void tick();
+    void run_until(uint64_t targetTick);
+
+    // A partition's programs_added leaves out the programs it handed to other partitions.
+    cluster_statistics get_statistics(size_t partition);
+    cluster_statistics get_statistics();
+    const load_timeline& timeline(size_t partition) const { return mPartitions.at(partition).simulator->timeline(); }
+
+    uint64_t current_tick() const noexcept { return mCurrentTick; }
+    uint64_t processors() const noexcept;
+};
\ No newline at end of file
@@ -3,34 +3,18 @@
 #include <cstdint>
 #include "linked_list.h"
 #include "program_info.h"
+#include "queue_traits.h"
 #include "cluster_state.h"
 
-template<uint64_t LookAhead = UINT64_MAX>
+template<uint64_t LookAhead = UINT64_MAX, template<typename> class Storage = linked_list>
 class planning_queue
 {
 private:
     uint64_t mNextId;
-    linked_list<std::pair<uint64_t, program_info>> mPrograms;
-
-    uint64_t get_ticks_wait(const cluster_state& state, uint64_t processorsRequired)
-    {
-        uint64_t l = 0, r = UINT64_MAX;
-        while (r - l > 1)
-        {
-            uint64_t m = l + (r - l) / 2;
-            uint64_t c = 0;
-
-            for (const auto& p : state.processors)
-                if (p.busy && p.tickEnd < state.currentTick + m) ++c;
-
-            if (state.freeProcessors + c >= processorsRequired) r = m;
-            else l = m;
-        }
-
-        return r;
-    }
+    uint64_t mLookAhead;
+    Storage<std::pair<uint64_t, program_info>> mPrograms;
 public:
-    planning_queue() : mNextId(0) {}
+    planning_queue(uint64_t lookAhead = LookAhead) : mNextId(0), mLookAhead(lookAhead) {}
 
     std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
     {
@@ -47,9 +31,9 @@ public:
             return p;
         }
 
-        uint64_t timeToStart = get_ticks_wait(state, requiredProcessors);
+        uint64_t timeToStart = state.completions.ticks_wait(state.currentTick, state.freeProcessors, requiredProcessors);
 
-        uint64_t lookAhead = LookAhead;
+        uint64_t lookAhead = mLookAhead;
         for (auto iter = mPrograms.begin(); iter != mPrograms.end() && lookAhead > 0; ++iter, --lookAhead)
         {
             const auto& p = *iter;
@@ -70,4 +54,30 @@ public:
         mPrograms.push_back({ id, program });
         return id;
     }
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        return push_programs(mPrograms, mNextId, programs, count);
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& p : mPrograms)
+        {
+            f(p);
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        mPrograms.save(writer);
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        mPrograms.load(reader);
+    }
 };
\ No newline at end of file
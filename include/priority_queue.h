@@ -1,11 +1,14 @@
 #pragma once
 #include <optional>
 #include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include "linked_list.h"
 #include "program_info.h"
 #include "cluster_state.h"
 
-template<uint64_t MaxDelay = 0LL>
+template<uint64_t MaxDelay = 0LL, template<typename> class Storage = linked_list>
 class priority_queue
 {
 private:
@@ -17,33 +20,173 @@ private:
     };
 
     uint64_t mNextId;
-    linked_list<program_record> mPrograms;
+    uint64_t mMaxDelay;
+    std::vector<Storage<program_record>> mBuckets;
+    std::vector<std::pair<uint64_t, uint64_t>> mOldest;
+    uint64_t mLeaves;
+
+    std::pair<uint64_t, uint64_t> bucket_oldest(uint64_t width)
+    {
+        if (width >= mBuckets.size() || mBuckets[width].is_empty())
+        {
+            return { UINT64_MAX, width };
+        }
+
+        return { mBuckets[width].front().program_id, width };
+    }
+
+    void update_oldest(uint64_t width)
+    {
+        uint64_t i = mLeaves + width;
+        mOldest[i] = bucket_oldest(width);
+        for (i /= 2; i > 0; i /= 2)
+        {
+            mOldest[i] = std::min(mOldest[2 * i], mOldest[2 * i + 1]);
+        }
+    }
+
+    void grow(uint64_t width)
+    {
+        mBuckets.resize(width + 1);
+        if (width < mLeaves)
+        {
+            return;
+        }
+
+        while (mLeaves <= width)
+        {
+            mLeaves *= 2;
+        }
+
+        rebuild_oldest();
+    }
+
+    void rebuild_oldest()
+    {
+        mOldest.assign(2 * mLeaves, { UINT64_MAX, 0 });
+        for (uint64_t w = 0; w < mBuckets.size(); ++w)
+        {
+            mOldest[mLeaves + w] = bucket_oldest(w);
+        }
+        for (uint64_t i = mLeaves - 1; i > 0; --i)
+        {
+            mOldest[i] = std::min(mOldest[2 * i], mOldest[2 * i + 1]);
+        }
+    }
+
+    std::pair<uint64_t, uint64_t> oldest_in(uint64_t minWidth, uint64_t maxWidth) const
+    {
+        std::pair<uint64_t, uint64_t> res{ UINT64_MAX, 0 };
+        if (minWidth >= mLeaves || minWidth > maxWidth)
+        {
+            return res;
+        }
+        if (maxWidth >= mLeaves)
+        {
+            maxWidth = mLeaves - 1;
+        }
+
+        for (uint64_t l = minWidth + mLeaves, r = maxWidth + mLeaves + 1; l < r; l /= 2, r /= 2)
+        {
+            if (l & 1) res = std::min(res, mOldest[l++]);
+            if (r & 1) res = std::min(res, mOldest[--r]);
+        }
+
+        return res;
+    }
 public:
-    priority_queue() : mNextId(0) {}
+    priority_queue(uint64_t maxDelay = MaxDelay) : mNextId(0), mMaxDelay(maxDelay), mOldest(2, { UINT64_MAX, 0 }), mLeaves(1) {}
 
     std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
     {
-        for (auto iter = mPrograms.begin(); iter != mPrograms.end(); ++iter)
+        const auto fitting = oldest_in(0, state.freeProcessors);
+        if (fitting.first == UINT64_MAX)
         {
-            const auto& p = *iter;
-            if (p.program_info.processors <= state.freeProcessors)
-            {
-                std::pair<uint64_t, program_info> res{ p.program_id, p.program_info };
-                mPrograms.erase(iter);
-                return res;
-            } else if (state.currentTick - p.tick_added > MaxDelay)
+            return std::nullopt;
+        }
+
+        if (state.freeProcessors < UINT64_MAX)
+        {
+            const auto blocking = oldest_in(state.freeProcessors + 1, UINT64_MAX);
+            if (blocking.first < fitting.first
+                && state.currentTick - mBuckets[blocking.second].front().tick_added > mMaxDelay)
             {
-                break;
+                return std::nullopt;
             }
         }
 
-        return std::nullopt;
+        auto& bucket = mBuckets[fitting.second];
+        std::pair<uint64_t, program_info> res{ bucket.front().program_id, bucket.front().program_info };
+        bucket.pop_front();
+        update_oldest(fitting.second);
+        return res;
     }
 
     uint64_t push(const program_info& program, uint64_t tick)
     {
         uint64_t id = mNextId++;
-        mPrograms.push_back({ id, tick, program });
+        if (program.processors >= mBuckets.size())
+        {
+            grow(program.processors);
+        }
+
+        mBuckets[program.processors].push_back({ id, tick, program });
+        if (mBuckets[program.processors].size() == 1)
+        {
+            update_oldest(program.processors);
+        }
         return id;
     }
+
+    uint64_t push_batch(const program_info* programs, size_t count, uint64_t tick)
+    {
+        uint64_t firstId = mNextId;
+        for (size_t i = 0; i < count; ++i)
+        {
+            push(programs[i], tick);
+        }
+        return firstId;
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& bucket : mBuckets)
+        {
+            for (const auto& record : bucket)
+            {
+                f(std::pair<uint64_t, program_info>{ record.program_id, record.program_info });
+            }
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write(mNextId);
+        writer.write(mLeaves);
+        writer.write<uint64_t>(mBuckets.size());
+        for (const auto& bucket : mBuckets)
+        {
+            bucket.save(writer);
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        reader.read(mNextId);
+        reader.read(mLeaves);
+        const uint64_t buckets = reader.read<uint64_t>();
+        if (mLeaves == 0 || (mLeaves & (mLeaves - 1)) != 0 || buckets > mLeaves || (mLeaves > 1 && mLeaves / 2 >= buckets))
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted queue snapshot.");
+        }
+
+        mBuckets.clear();
+        mBuckets.resize(buckets);
+        for (auto& bucket : mBuckets)
+        {
+            bucket.load(reader);
+        }
+        rebuild_oldest();
+    }
 };
\ No newline at end of file
@@ -3,12 +3,14 @@
 
 struct processor_state
 {
-    uint64_t tickStart;
-    uint64_t tickEnd;
-    uint64_t programId;
-    bool busy;
+    static constexpr uint32_t none = UINT32_MAX;
 
-    processor_state(uint64_t start = 0, uint64_t end = 0, uint64_t pid = 0, bool busy_ = false)
-        : tickStart(start), tickEnd(end), programId(pid), busy(busy_)
+    uint32_t programSlot;
+    uint32_t nextProcessor;
+
+    processor_state(uint32_t slot = none, uint32_t next = none)
+        : programSlot(slot), nextProcessor(next)
     {}
+
+    bool busy() const noexcept { return programSlot != none; }
 };
\ No newline at end of file
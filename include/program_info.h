@@ -1,8 +1,18 @@
 #pragma once
 #include <cstdint>
 
+// executionTime is the requested limit that schedulers plan with. The program finishes
+// after actualTime ticks if that is shorter, and is killed at the limit otherwise.
+// userId names the account charged for the program's processor-ticks.
 struct program_info
 {
     uint64_t processors;
     uint64_t executionTime;
+    uint64_t actualTime = UINT64_MAX;
+    uint64_t userId = 0;
+    uint64_t tickSubmitted = 0;
+
+    uint64_t occupied_ticks() const noexcept { return executionTime > 0 ? executionTime : 1; }
+    uint64_t run_time() const noexcept { return actualTime < executionTime ? actualTime : executionTime; }
+    bool exceeds_limit() const noexcept { return actualTime != UINT64_MAX && actualTime > executionTime; }
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include "program_info.h"
+#include "running_program.h"
+
+template<typename T, typename = void>
+struct has_push_batch : std::false_type {};
+
+template<typename T>
+struct has_push_batch<T, std::void_t<decltype(std::declval<T&>().push_batch(
+    std::declval<const program_info*>(), std::declval<size_t>(), std::declval<uint64_t>()))>> : std::true_type {};
+
+template<typename S, typename = void>
+struct has_reserve : std::false_type {};
+
+template<typename S>
+struct has_reserve<S, std::void_t<decltype(std::declval<S&>().reserve(std::declval<size_t>()))>> : std::true_type {};
+
+// Shared push_batch body of the queues that keep (id, program) pairs in arrival order.
+template<typename Storage>
+uint64_t push_programs(Storage& storage, uint64_t& nextId, const program_info* programs, size_t count)
+{
+    uint64_t firstId = nextId;
+    nextId += count;
+    if constexpr (has_reserve<Storage>::value)
+    {
+        storage.reserve(storage.size() + count);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        storage.push_back({ firstId + i, programs[i] });
+    }
+    return firstId;
+}
+
+// Queues that account for finished programs get on_finish(program, tick) as each one ends.
+template<typename T, typename = void>
+struct has_on_finish : std::false_type {};
+
+template<typename T>
+struct has_on_finish<T, std::void_t<decltype(std::declval<T&>().on_finish(
+    std::declval<const running_program&>(), std::declval<uint64_t>()))>> : std::true_type {};
\ No newline at end of file
@@ -0,0 +1,251 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <initializer_list>
+#include <stdexcept>
+#include "binary_io.h"
+
+template<typename T>
+class ring_buffer
+{
+private:
+    static constexpr size_t min_capacity = 16;
+    static constexpr size_t min_compaction = 32;
+
+    std::vector<T> mData;
+    std::vector<unsigned char> mErased;
+    size_t mHead;
+    size_t mCount;
+    size_t mSize;
+
+    size_t physical(size_t offset) const noexcept
+    {
+        return (mHead + offset) & (mData.size() - 1);
+    }
+
+    void relocate(size_t capacity)
+    {
+        std::vector<T> data(capacity);
+        std::vector<unsigned char> erased(capacity, 0);
+
+        size_t j = 0;
+        for (size_t i = 0; i < mCount; ++i)
+        {
+            if (!mErased[physical(i)])
+            {
+                data[j++] = std::move(mData[physical(i)]);
+            }
+        }
+
+        mData.swap(data);
+        mErased.swap(erased);
+        mHead = 0;
+        mCount = mSize;
+    }
+
+    void trim()
+    {
+        while (mCount > 0 && mErased[physical(0)])
+        {
+            mErased[physical(0)] = 0;
+            mHead = physical(1);
+            --mCount;
+        }
+
+        while (mCount > 0 && mErased[physical(mCount - 1)])
+        {
+            mErased[physical(mCount - 1)] = 0;
+            --mCount;
+        }
+    }
+
+public:
+    struct iterator
+    {
+    private:
+        const ring_buffer* mBuffer;
+        size_t mOffset;
+
+        iterator(const ring_buffer* buffer, size_t offset) noexcept : mBuffer(buffer), mOffset(offset) {}
+    public:
+        iterator& operator++()
+        {
+            if (mOffset >= mBuffer->mCount)
+            {
+                throw std::out_of_range(__FUNCTION__ ": can't increment end() iterator.");
+            }
+
+            do
+            {
+                ++mOffset;
+            } while (mOffset < mBuffer->mCount && mBuffer->mErased[mBuffer->physical(mOffset)]);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return mBuffer == other.mBuffer && mOffset == other.mOffset;
+        }
+
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        const T& operator*() const
+        {
+            if (mOffset >= mBuffer->mCount)
+            {
+                throw std::out_of_range(__FUNCTION__ ": can't dereference end() iterator.");
+            }
+
+            return mBuffer->mData[mBuffer->physical(mOffset)];
+        }
+
+        friend class ring_buffer;
+    };
+
+    ring_buffer() : mData(min_capacity), mErased(min_capacity, 0), mHead(0), mCount(0), mSize(0) {}
+    ring_buffer(const std::initializer_list<T>& elems) : ring_buffer()
+    {
+        for (const auto& elem : elems)
+        {
+            push_back(elem);
+        }
+    }
+
+    size_t size() const noexcept { return mSize; }
+    bool is_empty() const noexcept { return size() == 0; }
+    size_t capacity() const noexcept { return mData.size(); }
+
+    void reserve(size_t count)
+    {
+        size_t capacity = mData.size();
+        while (capacity < count)
+        {
+            capacity *= 2;
+        }
+
+        if (capacity != mData.size())
+        {
+            relocate(capacity);
+        }
+    }
+
+    void push_back(const T& elem)
+    {
+        if (mCount == mData.size())
+        {
+            relocate(mSize * 2 > mData.size() ? mData.size() * 2 : mData.size());
+        }
+
+        mData[physical(mCount)] = elem;
+        ++mCount;
+        ++mSize;
+    }
+
+    void pop_front()
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't pop front element of empty buffer.");
+        }
+
+        mData[physical(0)] = T();
+        mHead = physical(1);
+        --mCount;
+        --mSize;
+        trim();
+    }
+
+    void pop_back()
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't pop back element from empty buffer.");
+        }
+
+        mData[physical(mCount - 1)] = T();
+        --mCount;
+        --mSize;
+        trim();
+    }
+
+    void clear()
+    {
+        mData.assign(min_capacity, T());
+        mErased.assign(min_capacity, 0);
+        mHead = 0;
+        mCount = 0;
+        mSize = 0;
+    }
+
+    const T& back() const
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't get back from empty buffer.");
+        }
+
+        return mData[physical(mCount - 1)];
+    }
+
+    const T& front() const
+    {
+        if (is_empty())
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't get front from empty buffer.");
+        }
+
+        return mData[physical(0)];
+    }
+
+    void erase(const iterator& pos)
+    {
+        if (pos.mBuffer != this || pos.mOffset >= mCount)
+        {
+            throw std::out_of_range(__FUNCTION__ ": can't erase after end of buffer.");
+        }
+
+        mData[physical(pos.mOffset)] = T();
+        mErased[physical(pos.mOffset)] = 1;
+        --mSize;
+        trim();
+
+        if (mCount - mSize > min_compaction && mCount - mSize > mSize)
+        {
+            relocate(mData.size());
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write<uint64_t>(mSize);
+        for (const auto& elem : *this)
+        {
+            writer.write(elem);
+        }
+    }
+
+    void load(binary_reader& reader)
+    {
+        clear();
+        const uint64_t size = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            T elem;
+            reader.read(elem);
+            push_back(elem);
+        }
+    }
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, mCount); }
+};
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+struct running_program
+{
+    uint64_t programId;
+    uint64_t tickSubmitted;
+    uint64_t tickStart;
+    uint64_t tickEnd;
+    uint64_t tickLimit;
+    uint64_t processors;
+    uint32_t firstProcessor;
+    uint64_t userId;
+    bool killed;
+    bool active;
+};
\ No newline at end of file
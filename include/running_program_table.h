@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include "binary_io.h"
+#include "running_program.h"
+
+class running_program_table
+{
+private:
+    std::vector<running_program> mRecords;
+    std::vector<uint32_t> mFreeSlots;
+    uint64_t mSize;
+
+public:
+    running_program_table() : mSize(0) {}
+
+    uint64_t size() const noexcept { return mSize; }
+    bool is_empty() const noexcept { return mSize == 0; }
+    uint64_t capacity() const noexcept { return mRecords.size(); }
+
+    uint32_t insert(const running_program& program)
+    {
+        uint32_t slot;
+        if (!mFreeSlots.empty())
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+            mRecords[slot] = program;
+        } else
+        {
+            if (mRecords.size() >= UINT32_MAX)
+            {
+                throw std::length_error(__FUNCTION__ ": too many running programs.");
+            }
+
+            slot = (uint32_t)mRecords.size();
+            mRecords.push_back(program);
+        }
+
+        mRecords[slot].active = true;
+        ++mSize;
+        return slot;
+    }
+
+    void erase(uint32_t slot)
+    {
+        if (slot >= mRecords.size() || !mRecords[slot].active)
+        {
+            throw std::out_of_range(__FUNCTION__ ": slot doesn't hold a running program.");
+        }
+
+        mRecords[slot].active = false;
+        mFreeSlots.push_back(slot);
+        --mSize;
+    }
+
+    void set_first_processor(uint32_t slot, uint32_t processor)
+    {
+        if (slot >= mRecords.size() || !mRecords[slot].active)
+        {
+            throw std::out_of_range(__FUNCTION__ ": slot doesn't hold a running program.");
+        }
+
+        mRecords[slot].firstProcessor = processor;
+    }
+
+    const running_program& operator[](uint32_t slot) const
+    {
+        if (slot >= mRecords.size() || !mRecords[slot].active)
+        {
+            throw std::out_of_range(__FUNCTION__ ": slot doesn't hold a running program.");
+        }
+
+        return mRecords[slot];
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for (const auto& record : mRecords)
+        {
+            if (record.active)
+            {
+                f(record);
+            }
+        }
+    }
+
+    void save(binary_writer& writer) const
+    {
+        writer.write<uint64_t>(mRecords.size());
+        for (const auto& record : mRecords)
+        {
+            writer.write(record.programId);
+            writer.write(record.tickSubmitted);
+            writer.write(record.tickStart);
+            writer.write(record.tickEnd);
+            writer.write(record.tickLimit);
+            writer.write(record.processors);
+            writer.write(record.firstProcessor);
+            writer.write(record.userId);
+            writer.write(record.killed);
+            writer.write(record.active);
+        }
+        writer.write(mFreeSlots);
+        writer.write(mSize);
+    }
+
+    void load(binary_reader& reader)
+    {
+        const uint64_t records = reader.read<uint64_t>();
+        if (records > UINT32_MAX)
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted program table snapshot.");
+        }
+
+        mRecords.clear();
+        for (uint64_t i = 0; i < records; ++i)
+        {
+            running_program record;
+            reader.read(record.programId);
+            reader.read(record.tickSubmitted);
+            reader.read(record.tickStart);
+            reader.read(record.tickEnd);
+            reader.read(record.tickLimit);
+            reader.read(record.processors);
+            reader.read(record.firstProcessor);
+            reader.read(record.userId);
+            reader.read(record.killed);
+            reader.read(record.active);
+            mRecords.push_back(record);
+        }
+        reader.read(mFreeSlots);
+        reader.read(mSize);
+    }
+};
\ No newline at end of file
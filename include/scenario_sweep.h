@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "cluster_management_system.h"
+#include "cluster_statistics.h"
+#include "program_info.h"
+#include "scheduler_registry.h"
+
+struct sweep_scenario
+{
+    std::string policy;
+    uint64_t processors;
+    double arrivalRate;
+    uint64_t seed;
+    uint64_t ticks;
+};
+
+struct sweep_result
+{
+    sweep_scenario scenario;
+    cluster_statistics statistics;
+};
+
+using sweep_simulation = cluster_statistics(*)(const sweep_scenario&);
+
+// System is cluster_management_system<T> or cluster_simulator; both see the same arrivals.
+template<typename System>
+cluster_statistics drive_scenario(const sweep_scenario& scenario, System& cms)
+{
+    std::seed_seq seed{ scenario.seed };
+    std::default_random_engine g(seed);
+    std::uniform_real_distribution<double> arrivalDist;
+    std::uniform_int_distribution<uint64_t> processorsDist(1, scenario.processors);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 200);
+
+    std::vector<program_info> arrivals;
+    for (uint64_t i = 0; i < scenario.ticks; ++i)
+    {
+        for (uint64_t j = 0; j < scenario.processors; ++j)
+        {
+            if (arrivalDist(g) < scenario.arrivalRate)
+            {
+                uint64_t processors = processorsDist(g);
+                arrivals.push_back({ processors, ticksDist(g) });
+            }
+        }
+
+        if (!arrivals.empty())
+        {
+            cms.run_until(i);
+            cms.add_programs(arrivals);
+            arrivals.clear();
+        }
+    }
+
+    cms.run_until(scenario.ticks);
+    return cms.get_statistics();
+}
+
+template<typename T>
+cluster_statistics simulate_scenario(const sweep_scenario& scenario)
+{
+    cluster_management_system<T> cms(scenario.processors);
+    return drive_scenario(scenario, cms);
+}
+
+std::map<std::string, sweep_simulation> default_sweep_policies();
+
+std::vector<sweep_result> run_sweep(const std::vector<sweep_scenario>& scenarios,
+    const std::map<std::string, sweep_simulation>& policies, size_t threads);
+
+// Scenario policies are scheduler specs, e.g. "easy:lookahead=100".
+std::vector<sweep_result> run_sweep(const std::vector<sweep_scenario>& scenarios,
+    const scheduler_registry& registry, size_t threads);
+
+void print_sweep_table(std::ostream& ostr, const std::vector<sweep_result>& results);
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "cluster_management_system.h"
+#include "cluster_statistics.h"
+#include "load_timeline.h"
+#include "latency_histogram.h"
+#include "cluster_state.h"
+#include "binary_io.h"
+#include "program_info.h"
+
+// "planning:lookahead=100" names a policy and its parameters; "planning:100" sets the policy's
+// first parameter. "inf" stands for the largest value.
+struct scheduler_spec
+{
+    std::string name;
+    std::map<std::string, uint64_t> parameters;
+
+    uint64_t parameter(const std::string& key, uint64_t defaultValue) const
+    {
+        auto it = parameters.find(key);
+        return it == parameters.end() ? defaultValue : it->second;
+    }
+};
+
+// A simulator whose queue policy is chosen at run time. Only whole operations are virtual:
+// run_until and the other calls forward to cluster_management_system<T>, so the per-tick
+// loop and every get() are compiled for the concrete queue.
+class cluster_simulator
+{
+public:
+    virtual ~cluster_simulator() = default;
+
+    virtual void add_program(const program_info& info) = 0;
+    virtual void add_programs(const program_info* programs, size_t count) = 0;
+    virtual void submit_program(const program_info& info) = 0;
+    virtual cluster_statistics get_statistics() = 0;
+    virtual void tick() = 0;
+    virtual void begin_tick() = 0;
+    virtual void end_tick() = 0;
+    virtual void run_until(uint64_t targetTick) = 0;
+    virtual bool advance_to_next_event() = 0;
+    virtual void save(binary_writer& writer) = 0;
+    virtual void load(binary_reader& reader) = 0;
+    virtual std::unique_ptr<cluster_simulator> fork() = 0;
+    virtual void add_processors(uint64_t count) = 0;
+    virtual std::optional<std::pair<uint64_t, program_info>> migrate_program(const cluster_state& target) = 0;
+    virtual void adopt_program(uint64_t programId, const program_info& program) = 0;
+
+    virtual uint64_t current_tick() const noexcept = 0;
+    virtual uint64_t processors() const noexcept = 0;
+    virtual uint64_t free_processors() const noexcept = 0;
+    virtual uint64_t waiting_programs() const noexcept = 0;
+    virtual uint64_t programs_migrated() const noexcept = 0;
+    virtual const cluster_state& state() const noexcept = 0;
+    virtual const load_timeline& timeline() const noexcept = 0;
+    virtual const latency_histogram& wait_times() const noexcept = 0;
+    virtual const latency_histogram& turnaround_times() const noexcept = 0;
+    virtual const latency_histogram& bounded_slowdowns() const noexcept = 0;
+
+    template<typename Container>
+    void add_programs(const Container& programs)
+    {
+        add_programs(programs.data(), programs.size());
+    }
+};
+
+template<typename T>
+class simulator_model final : public cluster_simulator
+{
+private:
+    cluster_management_system<T> mSystem;
+
+public:
+    simulator_model(uint64_t processors, T queue) : mSystem(processors, std::move(queue)) {}
+    simulator_model(cluster_management_system<T>&& system) : mSystem(std::move(system)) {}
+
+    cluster_management_system<T>& system() noexcept { return mSystem; }
+
+    void add_program(const program_info& info) override { mSystem.add_program(info); }
+    void add_programs(const program_info* programs, size_t count) override { mSystem.add_programs(programs, count); }
+    void submit_program(const program_info& info) override { mSystem.submit_program(info); }
+    cluster_statistics get_statistics() override { return mSystem.get_statistics(); }
+    void tick() override { mSystem.tick(); }
+    void begin_tick() override { mSystem.begin_tick(); }
+    void end_tick() override { mSystem.end_tick(); }
+    void run_until(uint64_t targetTick) override { mSystem.run_until(targetTick); }
+    bool advance_to_next_event() override { return mSystem.advance_to_next_event(); }
+    void save(binary_writer& writer) override { mSystem.save(writer); }
+    void load(binary_reader& reader) override { mSystem.load(reader); }
+    std::unique_ptr<cluster_simulator> fork() override { return std::make_unique<simulator_model<T>>(mSystem.fork()); }
+    void add_processors(uint64_t count) override { mSystem.add_processors(count); }
+
+    std::optional<std::pair<uint64_t, program_info>> migrate_program(const cluster_state& target) override
+    {
+        return mSystem.migrate_program(target);
+    }
+
+    void adopt_program(uint64_t programId, const program_info& program) override { mSystem.adopt_program(programId, program); }
+
+    uint64_t current_tick() const noexcept override { return mSystem.current_tick(); }
+    uint64_t processors() const noexcept override { return mSystem.processors(); }
+    uint64_t free_processors() const noexcept override { return mSystem.free_processors(); }
+    uint64_t waiting_programs() const noexcept override { return mSystem.waiting_programs(); }
+    uint64_t programs_migrated() const noexcept override { return mSystem.programs_migrated(); }
+    const cluster_state& state() const noexcept override { return mSystem.state(); }
+    const load_timeline& timeline() const noexcept override { return mSystem.timeline(); }
+    const latency_histogram& wait_times() const noexcept override { return mSystem.wait_times(); }
+    const latency_histogram& turnaround_times() const noexcept override { return mSystem.turnaround_times(); }
+    const latency_histogram& bounded_slowdowns() const noexcept override { return mSystem.bounded_slowdowns(); }
+};
+
+class scheduler_registry
+{
+public:
+    using factory = std::function<std::unique_ptr<cluster_simulator>(uint64_t processors, const scheduler_spec& spec)>;
+
+private:
+    struct entry
+    {
+        std::vector<std::string> parameters;
+        factory make;
+    };
+
+    std::map<std::string, entry> mEntries;
+
+public:
+    // make builds the queue from a parsed spec; parameters lists the keys the spec may set.
+    template<typename T, typename Make>
+    void add(const std::string& name, std::vector<std::string> parameters, Make make)
+    {
+        mEntries[name] = { std::move(parameters), [make](uint64_t processors, const scheduler_spec& spec)
+        {
+            return std::unique_ptr<cluster_simulator>(std::make_unique<simulator_model<T>>(processors, make(spec)));
+        } };
+    }
+
+    bool contains(const std::string& name) const { return mEntries.count(name) != 0; }
+    std::vector<std::string> names() const;
+
+    scheduler_spec parse(const std::string& text) const;
+    std::unique_ptr<cluster_simulator> create(const std::string& spec, uint64_t processors) const;
+};
+
+const scheduler_registry& default_scheduler_registry();
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "mapped_file.h"
+#include "trace_job.h"
+
+class swf_reader
+{
+private:
+    std::optional<mapped_file> mFile;
+    const char* mCurrent;
+    const char* mEnd;
+    uint64_t mLine;
+    uint64_t mSkipped;
+
+    bool parse_line(const char* begin, const char* end, trace_job& job);
+
+public:
+    swf_reader(const std::string& path);
+    swf_reader(const char* data, size_t size);
+
+    bool next(trace_job& job);
+
+    uint64_t line() const noexcept { return mLine; }
+    uint64_t skipped() const noexcept { return mSkipped; }
+};
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class thread_pool
+{
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> mQueues;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mStateMutex;
+    std::condition_variable mWakeUp;
+    std::condition_variable mDone;
+    std::atomic<size_t> mQueued;
+    std::atomic<size_t> mNextQueue;
+    size_t mPending;
+    bool mStopping;
+    std::exception_ptr mError;
+
+    static std::pair<const thread_pool*, size_t>& current_worker() noexcept
+    {
+        static thread_local std::pair<const thread_pool*, size_t> worker{ nullptr, 0 };
+        return worker;
+    }
+
+    bool try_pop(size_t worker, std::function<void()>& task)
+    {
+        {
+            worker_queue& own = *mQueues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < mQueues.size(); ++i)
+        {
+            worker_queue& victim = *mQueues[(worker + i) % mQueues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work(size_t worker)
+    {
+        current_worker() = { this, worker };
+        std::function<void()> task;
+        while (true)
+        {
+            if (try_pop(worker, task))
+            {
+                --mQueued;
+                std::exception_ptr error;
+                try
+                {
+                    task();
+                } catch (...)
+                {
+                    error = std::current_exception();
+                }
+                task = nullptr;
+
+                std::lock_guard<std::mutex> lock(mStateMutex);
+                if (error && !mError)
+                {
+                    mError = error;
+                }
+                if (--mPending == 0)
+                {
+                    mDone.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mStateMutex);
+            mWakeUp.wait(lock, [this] { return mStopping || mQueued > 0; });
+            if (mStopping && mQueued == 0)
+            {
+                return;
+            }
+        }
+    }
+
+public:
+    thread_pool(size_t threads = std::thread::hardware_concurrency())
+        : mQueued(0), mNextQueue(0), mPending(0), mStopping(false)
+    {
+        if (threads == 0)
+        {
+            threads = 1;
+        }
+
+        for (size_t i = 0; i < threads; ++i)
+        {
+            mQueues.push_back(std::make_unique<worker_queue>());
+        }
+        for (size_t i = 0; i < threads; ++i)
+        {
+            mThreads.emplace_back(&thread_pool::work, this, i);
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mStateMutex);
+            mStopping = true;
+        }
+        mWakeUp.notify_all();
+
+        for (auto& thread : mThreads)
+        {
+            thread.join();
+        }
+    }
+
+    size_t size() const noexcept { return mThreads.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        size_t worker = current_worker().second;
+        if (current_worker().first != this)
+        {
+            worker = mNextQueue++ % mQueues.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mStateMutex);
+            ++mPending;
+            ++mQueued;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mQueues[worker]->mutex);
+            mQueues[worker]->tasks.push_back(std::move(task));
+        }
+        mWakeUp.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mStateMutex);
+        mDone.wait(lock, [this] { return mPending == 0; });
+
+        if (mError)
+        {
+            std::exception_ptr error = mError;
+            mError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+};
\ No newline at end of file
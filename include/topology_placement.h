@@ -0,0 +1,185 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <set>
+#include <utility>
+#include <stdexcept>
+#include "cluster_topology.h"
+#include "free_processor_index.h"
+#include "processor_state.h"
+#include "binary_io.h"
+
+// Chooses the nodes a program runs on. Free cores are counted per node and per rack, and the
+// counts are kept ordered, so a decision costs O(log nodes) per node used instead of a scan:
+// - a program that fits into one node takes the fullest node it fits into (best fit);
+// - otherwise it takes the rack with the fewest free cores it fits into, or the freest racks,
+//   and inside them the freest nodes, so it spans as few nodes as possible.
+class topology_placement
+{
+private:
+    using free_set = std::set<std::pair<uint64_t, uint32_t>>;
+
+    cluster_topology mTopology;
+    std::vector<uint64_t> mNodeFree;
+    std::vector<uint64_t> mRackFree;
+    free_set mNodesByFree;
+    free_set mRacksByFree;
+    std::vector<free_set> mRackNodesByFree;
+
+    void set_node_free(uint32_t node, uint64_t free)
+    {
+        const uint32_t rack = mTopology.rack_of(node);
+        const uint64_t rackFree = mRackFree[rack] - mNodeFree[node] + free;
+
+        mNodesByFree.erase({ mNodeFree[node], node });
+        mRackNodesByFree[rack].erase({ mNodeFree[node], node });
+        mRacksByFree.erase({ mRackFree[rack], rack });
+
+        mNodeFree[node] = free;
+        mRackFree[rack] = rackFree;
+
+        mNodesByFree.insert({ free, node });
+        mRackNodesByFree[rack].insert({ free, node });
+        mRacksByFree.insert({ rackFree, rack });
+    }
+
+    template<typename F>
+    uint64_t acquire_on_node(uint32_t node, uint64_t count, free_processor_index& index, F& onAcquired)
+    {
+        const uint64_t taken = count < mNodeFree[node] ? count : mNodeFree[node];
+        index.acquire_range(mTopology.node_begin(node), mTopology.node_end(node), taken, onAcquired);
+        set_node_free(node, mNodeFree[node] - taken);
+        return taken;
+    }
+
+    template<typename F>
+    uint32_t acquire_in_rack(uint32_t rack, uint64_t& count, free_processor_index& index, F& onAcquired)
+    {
+        uint32_t nodes = 0;
+        while (count > 0 && mRackFree[rack] > 0)
+        {
+            const uint32_t node = mRackNodesByFree[rack].rbegin()->second;
+            count -= acquire_on_node(node, count, index, onAcquired);
+            ++nodes;
+        }
+        return nodes;
+    }
+
+    void rebuild()
+    {
+        mRackFree.assign(mTopology.rack_count(), 0);
+        mNodesByFree.clear();
+        mRacksByFree.clear();
+        mRackNodesByFree.assign(mTopology.rack_count(), free_set());
+
+        for (uint32_t node = 0; node < mTopology.node_count(); ++node)
+        {
+            mRackFree[mTopology.rack_of(node)] += mNodeFree[node];
+            mNodesByFree.insert({ mNodeFree[node], node });
+            mRackNodesByFree[mTopology.rack_of(node)].insert({ mNodeFree[node], node });
+        }
+
+        for (uint32_t rack = 0; rack < mTopology.rack_count(); ++rack)
+        {
+            mRacksByFree.insert({ mRackFree[rack], rack });
+        }
+    }
+
+public:
+    topology_placement() = default;
+
+    explicit topology_placement(const cluster_topology& topology)
+        : mTopology(topology), mNodeFree(topology.node_count())
+    {
+        for (uint32_t node = 0; node < topology.node_count(); ++node)
+        {
+            mNodeFree[node] = topology.node_cores(node);
+        }
+        rebuild();
+    }
+
+    bool is_empty() const noexcept { return mTopology.node_count() == 0; }
+    const cluster_topology& topology() const noexcept { return mTopology; }
+    uint64_t node_free(uint32_t node) const { return mNodeFree[node]; }
+
+    // Returns the number of nodes the processors were taken from.
+    template<typename F>
+    uint32_t acquire(uint64_t count, free_processor_index& index, F&& onAcquired)
+    {
+        if (count > index.free_count())
+        {
+            throw std::out_of_range(__FUNCTION__ ": not enough free processors.");
+        }
+
+        free_set::iterator node = mNodesByFree.lower_bound({ count, 0 });
+        if (node != mNodesByFree.end())
+        {
+            acquire_on_node(node->second, count, index, onAcquired);
+            return 1;
+        }
+
+        uint32_t nodes = 0;
+        free_set::iterator rack = mRacksByFree.lower_bound({ count, 0 });
+        if (rack != mRacksByFree.end())
+        {
+            return acquire_in_rack(rack->second, count, index, onAcquired);
+        }
+
+        while (count > 0)
+        {
+            nodes += acquire_in_rack(mRacksByFree.rbegin()->second, count, index, onAcquired);
+        }
+        return nodes;
+    }
+
+    // Processors of a program are chained node by node, so every node is updated once.
+    template<typename Processors>
+    void release_chain(uint32_t first, const Processors& processors)
+    {
+        uint32_t node = 0;
+        uint64_t released = 0;
+        for (uint32_t i = first; i != processor_state::none; i = processors[i].nextProcessor)
+        {
+            if (released > 0 && (i < mTopology.node_begin(node) || i >= mTopology.node_end(node)))
+            {
+                set_node_free(node, mNodeFree[node] + released);
+                released = 0;
+            }
+
+            if (released == 0)
+            {
+                node = mTopology.node_of(i);
+            }
+            ++released;
+        }
+
+        if (released > 0)
+        {
+            set_node_free(node, mNodeFree[node] + released);
+        }
+    }
+
+    void add_node(uint32_t cores)
+    {
+        mTopology.add_node(cores);
+        mNodeFree.push_back(cores);
+        rebuild();
+    }
+
+    void save(binary_writer& writer) const
+    {
+        mTopology.save(writer);
+        writer.write(mNodeFree);
+    }
+
+    void load(binary_reader& reader)
+    {
+        mTopology.load(reader);
+        reader.read(mNodeFree);
+        if (mNodeFree.size() != mTopology.node_count())
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted placement snapshot.");
+        }
+        rebuild();
+    }
+};
\ No newline at end of file
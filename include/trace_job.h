@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+struct trace_job
+{
+    uint64_t submitTick;
+    uint64_t processors;
+    uint64_t runTime;
+    uint64_t requestedTime;
+    uint64_t userId;
+};
\ No newline at end of file
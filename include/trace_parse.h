@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+inline bool is_trace_space(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool parse_trace_number(const char*& cur, const char* end, int64_t& value, char separator = ' ')
+{
+    while (cur < end && is_trace_space(*cur))
+    {
+        ++cur;
+    }
+    if (cur == end)
+    {
+        return false;
+    }
+
+    bool negative = false;
+    if (*cur == '-')
+    {
+        negative = true;
+        ++cur;
+    }
+
+    const char* digits = cur;
+    value = 0;
+    while (cur < end && *cur >= '0' && *cur <= '9')
+    {
+        value = value * 10 + (*cur - '0');
+        ++cur;
+    }
+    if (cur < end && *cur == '.')
+    {
+        ++cur;
+        while (cur < end && *cur >= '0' && *cur <= '9')
+        {
+            ++cur;
+        }
+    }
+
+    if (cur == digits || (cur < end && !is_trace_space(*cur) && *cur != separator))
+    {
+        return false;
+    }
+
+    if (negative)
+    {
+        value = -value;
+    }
+    return true;
+}
\ No newline at end of file
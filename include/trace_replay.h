@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "cluster_management_system.h"
+#include "program_info.h"
+#include "trace_job.h"
+
+template<typename T, typename Reader>
+class trace_replay
+{
+private:
+    cluster_management_system<T>& mSystem;
+    Reader& mReader;
+    std::vector<program_info> mWindow;
+    size_t mWindowSize;
+    trace_job mPending;
+    bool mHasPending;
+    uint64_t mJobsReplayed;
+    uint64_t mJobsRejected;
+
+    bool fetch()
+    {
+        while (mReader.next(mPending))
+        {
+            if (mPending.processors <= mSystem.processors())
+            {
+                return true;
+            }
+
+            ++mJobsRejected;
+        }
+
+        return false;
+    }
+
+public:
+    trace_replay(cluster_management_system<T>& system, Reader& reader, size_t windowSize = 4096)
+        : mSystem(system), mReader(reader), mWindowSize(windowSize), mJobsReplayed(0), mJobsRejected(0)
+    {
+        if (windowSize < 1)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": window must hold at least one job.");
+        }
+
+        mWindow.reserve(windowSize);
+        mHasPending = fetch();
+    }
+
+    bool step()
+    {
+        if (!mHasPending)
+        {
+            return false;
+        }
+
+        uint64_t submitTick = mPending.submitTick;
+        mWindow.clear();
+        do
+        {
+            mWindow.push_back(program_info{ mPending.processors, mPending.requestedTime, mPending.runTime, mPending.userId });
+            mHasPending = fetch();
+        } while (mHasPending && mPending.submitTick == submitTick && mWindow.size() < mWindowSize);
+
+        mSystem.run_until(submitTick);
+        mSystem.add_programs(mWindow);
+        mJobsReplayed += mWindow.size();
+        return true;
+    }
+
+    void run()
+    {
+        while (step()) {}
+    }
+
+    bool is_finished() const noexcept { return !mHasPending; }
+    uint64_t jobs_replayed() const noexcept { return mJobsReplayed; }
+    uint64_t jobs_rejected() const noexcept { return mJobsRejected; }
+};
\ No newline at end of file
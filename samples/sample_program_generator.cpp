@@ -1,9 +1,10 @@
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <random>
-#include "cluster_management_system.h"
-#include "basic_queue.h"
-#include "priority_queue.h"
-#include "planning_queue.h"
+#include <string>
+#include <vector>
+#include "scheduler_registry.h"
 
 using namespace std;
 
@@ -18,29 +19,44 @@ program_info generate_program()
     return { processors_dist(g), ticks_dist(g) };
 }
 
-int main()
+int main(int argc, char** argv)
 {
     g.seed(0);
 
     uniform_real_distribution<float> program_gen_dist;
 
-    //cluster_management_system<basic_queue> cms(64);
-    //cluster_management_system<priority_queue<1000>> cms(64);
-    cluster_management_system<planning_queue<100>> cms(64);
+    // e.g. "basic", "priority:maxdelay=1000", "easy:lookahead=100", "sjf:aging=1"
+    const string policy = argc > 2 ? argv[2] : "planning:lookahead=100";
+    unique_ptr<cluster_simulator> simulator = default_scheduler_registry().create(policy, 64);
+    cluster_simulator& cms = *simulator;
 
+    vector<program_info> arrivals;
     for (size_t i = 0; i < 1000000; ++i)
     {
         for (size_t j = 0; j < 64; ++j)
         {
             if (program_gen_dist(g) <= 0.05)
             {
-                cms.add_program(generate_program());
+                arrivals.push_back(generate_program());
             }
         }
 
-        cms.tick();
+        if (!arrivals.empty())
+        {
+            cms.run_until(i);
+            cms.add_programs(arrivals);
+            arrivals.clear();
+        }
     }
 
+    cms.run_until(1000000);
+
     cout << cms.get_statistics() << endl;
+
+    if (argc > 1)
+    {
+        ofstream timeline(argv[1]);
+        cms.timeline().write_csv(timeline, cms.timeline().overview_level());
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include "scenario_sweep.h"
+
+using namespace std;
+
+int main()
+{
+    const vector<string> policies = {
+        "basic", "priority:maxdelay=100", "planning:lookahead=100", "easy:lookahead=100",
+        "conservative:lookahead=100", "sjf:aging=1", "area:aging=10", "widest:aging=1"
+    };
+
+    vector<sweep_scenario> scenarios;
+    for (const auto& policy : policies)
+    {
+        for (uint64_t processors : { 64, 256 })
+        {
+            for (double rate : { 0.0003, 0.0004, 0.0005 })
+            {
+                for (uint64_t seed = 0; seed < 3; ++seed)
+                {
+                    scenarios.push_back({ policy, processors, rate, seed, 20000 });
+                }
+            }
+        }
+    }
+
+    print_sweep_table(cout, run_sweep(scenarios, default_scheduler_registry(), thread::hardware_concurrency()));
+    return 0;
+}
\ No newline at end of file
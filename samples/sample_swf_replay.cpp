@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include "binary_trace.h"
+#include "cluster_management_system.h"
+#include "planning_queue.h"
+#include "swf_reader.h"
+#include "trace_replay.h"
+
+using namespace std;
+
+template<typename Reader>
+void replay_trace(Reader& reader, uint64_t processors)
+{
+    cluster_management_system<planning_queue<100>> cms(processors);
+    trace_replay<planning_queue<100>, Reader> replay(cms, reader);
+
+    replay.run();
+    while (cms.advance_to_next_event()) {}
+
+    cout << cms.get_statistics() << endl;
+    cout << "Jobs replayed: " << replay.jobs_replayed() << endl;
+    cout << "Jobs rejected: " << replay.jobs_rejected() << endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        cerr << "usage: " << argv[0] << " <trace.swf|trace.mp2t> <processors> [start tick]" << endl;
+        return 1;
+    }
+
+    string path = argv[1];
+    uint64_t processors = stoull(argv[2]);
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".mp2t") == 0)
+    {
+        binary_trace_reader reader(path);
+        if (argc > 3)
+        {
+            reader.seek(stoull(argv[3]));
+        }
+        replay_trace(reader, processors);
+    } else
+    {
+        swf_reader reader(path);
+        replay_trace(reader, processors);
+        cout << "Records skipped: " << reader.skipped() << endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
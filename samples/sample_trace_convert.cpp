@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include "binary_trace.h"
+#include "csv_trace_reader.h"
+#include "swf_reader.h"
+
+using namespace std;
+
+static bool ends_with(const string& value, const string& suffix)
+{
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        cerr << "usage: " << argv[0] << " <trace.swf|trace.csv> <trace.mp2t>" << endl;
+        return 1;
+    }
+
+    binary_trace_writer writer(argv[2]);
+    uint64_t count;
+    if (ends_with(argv[1], ".csv"))
+    {
+        csv_trace_reader reader(argv[1]);
+        count = convert_trace(reader, writer);
+    } else
+    {
+        swf_reader reader(argv[1]);
+        count = convert_trace(reader, writer);
+    }
+
+    cout << "Jobs converted: " << count << endl;
+    return 0;
+}
\ No newline at end of file
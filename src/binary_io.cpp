@@ -0,0 +1,99 @@
+#include "binary_io.h"
+#include <cstring>
+#include <stdexcept>
+
+binary_writer::binary_writer(std::ostream& stream) : mStream(stream), mBuffer(buffer_size), mUsed(0) {}
+
+// Best effort only: destructors can't report errors, so callers that care flush() themselves.
+binary_writer::~binary_writer()
+{
+    try
+    {
+        flush();
+    }
+    catch (...) {}
+}
+
+void binary_writer::write_bytes(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    if (size >= buffer_size)
+    {
+        flush();
+        mStream.write(bytes, size);
+    } else
+    {
+        if (mUsed + size > buffer_size)
+        {
+            flush();
+        }
+        std::memcpy(mBuffer.data() + mUsed, bytes, size);
+        mUsed += size;
+    }
+
+    if (!mStream)
+    {
+        throw std::runtime_error(__FUNCTION__ ": can't write to stream.");
+    }
+}
+
+void binary_writer::flush()
+{
+    if (mUsed > 0)
+    {
+        mStream.write(mBuffer.data(), mUsed);
+        mUsed = 0;
+    }
+    mStream.flush();
+
+    if (!mStream)
+    {
+        throw std::runtime_error(__FUNCTION__ ": can't write to stream.");
+    }
+}
+
+void binary_writer::write(const std::string& value)
+{
+    write<uint64_t>(value.size());
+    write_bytes(value.data(), value.size());
+}
+
+binary_reader::binary_reader(std::istream& stream) : mStream(stream), mBuffer(buffer_size), mPosition(0), mAvailable(0) {}
+
+void binary_reader::read_bytes(void* data, size_t size)
+{
+    char* bytes = static_cast<char*>(data);
+    while (size > 0)
+    {
+        if (mPosition == mAvailable)
+        {
+            mStream.read(mBuffer.data(), buffer_size);
+            mAvailable = (size_t)mStream.gcount();
+            mPosition = 0;
+            if (mAvailable == 0)
+            {
+                throw std::runtime_error(__FUNCTION__ ": unexpected end of stream.");
+            }
+        }
+
+        const size_t count = mAvailable - mPosition < size ? mAvailable - mPosition : size;
+        std::memcpy(bytes, mBuffer.data() + mPosition, count);
+        mPosition += count;
+        bytes += count;
+        size -= count;
+    }
+}
+
+void binary_reader::read(std::string& value)
+{
+    const uint64_t size = read<uint64_t>();
+    value.clear();
+    char chunk[256];
+    for (uint64_t done = 0; done < size; )
+    {
+        const size_t count = size - done < sizeof(chunk) ? (size_t)(size - done) : sizeof(chunk);
+        read_bytes(chunk, count);
+        value.append(chunk, count);
+        done += count;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "binary_trace.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const char trace_magic[8] = { 'M', 'P', '2', 'T', 'R', 'A', 'C', 'E' };
+    // Version 1 traces have no user ids; they read as user 0.
+    const uint32_t trace_version = 2;
+    const size_t header_size = 32;
+    const size_t index_entry_size = 16;
+
+    void put_u32(unsigned char* out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = (unsigned char)(value >> (8 * i));
+        }
+    }
+
+    void put_u64(unsigned char* out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            out[i] = (unsigned char)(value >> (8 * i));
+        }
+    }
+
+    uint32_t get_u32(const unsigned char* in)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            value |= (uint32_t)in[i] << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t get_u64(const unsigned char* in)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            value |= (uint64_t)in[i] << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t zigzag(uint64_t from, uint64_t to)
+    {
+        int64_t delta = (int64_t)(to - from);
+        return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+    }
+
+    uint64_t unzigzag(uint64_t from, uint64_t value)
+    {
+        return from + ((value >> 1) ^ (0 - (value & 1)));
+    }
+
+    void put_varint(std::vector<unsigned char>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((unsigned char)value);
+    }
+
+    uint64_t get_varint(const unsigned char*& cur, const unsigned char* end)
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (cur == end)
+            {
+                throw std::runtime_error(__FUNCTION__ ": truncated trace record.");
+            }
+
+            unsigned char byte = *cur++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+
+        throw std::runtime_error(__FUNCTION__ ": malformed trace record.");
+    }
+}
+
+binary_trace_writer::binary_trace_writer(const std::string& path, uint32_t blockSize)
+    : mStream(path, std::ios::binary | std::ios::trunc), mBlockSize(blockSize), mBlockJobs(0),
+    mJobCount(0), mOffset(header_size), mLastSubmitTick(0), mClosed(false)
+{
+    if (blockSize < 1)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": block must hold at least one job.");
+    }
+
+    if (!mStream)
+    {
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't open file " + path + ".");
+    }
+
+    unsigned char header[header_size] = {};
+    mStream.write(reinterpret_cast<const char*>(header), header_size);
+}
+
+binary_trace_writer::~binary_trace_writer()
+{
+    try
+    {
+        close();
+    }
+    catch (...) {}
+}
+
+void binary_trace_writer::flush_block()
+{
+    mStream.write(reinterpret_cast<const char*>(mBlock.data()), mBlock.size());
+    mOffset += mBlock.size();
+    mBlock.clear();
+    mBlockJobs = 0;
+}
+
+void binary_trace_writer::write(const trace_job& job)
+{
+    if (mClosed)
+    {
+        throw std::logic_error(__FUNCTION__ ": can't write to closed trace.");
+    }
+
+    if (mBlockJobs == 0)
+    {
+        mIndex.push_back({ mOffset, job.submitTick });
+        mLastSubmitTick = job.submitTick;
+    }
+
+    put_varint(mBlock, zigzag(mLastSubmitTick, job.submitTick));
+    put_varint(mBlock, job.processors);
+    put_varint(mBlock, job.runTime);
+    put_varint(mBlock, zigzag(job.runTime, job.requestedTime));
+    put_varint(mBlock, job.userId);
+    mLastSubmitTick = job.submitTick;
+    ++mJobCount;
+
+    if (++mBlockJobs == mBlockSize)
+    {
+        flush_block();
+    }
+}
+
+void binary_trace_writer::close()
+{
+    if (mClosed)
+    {
+        return;
+    }
+    mClosed = true;
+
+    flush_block();
+
+    uint64_t indexOffset = mOffset;
+    for (const binary_trace_block& block : mIndex)
+    {
+        unsigned char entry[index_entry_size];
+        put_u64(entry, block.offset);
+        put_u64(entry + 8, block.firstSubmitTick);
+        mStream.write(reinterpret_cast<const char*>(entry), index_entry_size);
+    }
+
+    unsigned char header[header_size];
+    std::memcpy(header, trace_magic, sizeof(trace_magic));
+    put_u32(header + 8, trace_version);
+    put_u32(header + 12, mBlockSize);
+    put_u64(header + 16, mJobCount);
+    put_u64(header + 24, indexOffset);
+    mStream.seekp(0);
+    mStream.write(reinterpret_cast<const char*>(header), header_size);
+    mStream.close();
+
+    if (mStream.fail())
+    {
+        throw std::runtime_error(__FUNCTION__ ": can't write trace.");
+    }
+}
+
+binary_trace_reader::binary_trace_reader(const std::string& path) : mFile(std::in_place, path)
+{
+    mData = reinterpret_cast<const unsigned char*>(mFile->data());
+    open(mFile->size());
+}
+
+binary_trace_reader::binary_trace_reader(const char* data, size_t size)
+{
+    mData = reinterpret_cast<const unsigned char*>(data);
+    open(size);
+}
+
+void binary_trace_reader::open(size_t size)
+{
+    if (size < header_size || std::memcmp(mData, trace_magic, sizeof(trace_magic)) != 0)
+    {
+        throw std::runtime_error(__FUNCTION__ ": not a binary trace.");
+    }
+
+    mVersion = get_u32(mData + 8);
+    if (mVersion < 1 || mVersion > trace_version)
+    {
+        throw std::runtime_error(__FUNCTION__ ": unsupported binary trace version.");
+    }
+
+    mBlockSize = get_u32(mData + 12);
+    mJobCount = get_u64(mData + 16);
+    uint64_t indexOffset = get_u64(mData + 24);
+    if (mBlockSize < 1)
+    {
+        throw std::runtime_error(__FUNCTION__ ": corrupted binary trace header.");
+    }
+
+    // Written without rounding up, so a hostile job count can't wrap around to zero blocks.
+    mBlockCount = mJobCount / mBlockSize + (mJobCount % mBlockSize != 0 ? 1 : 0);
+    if (indexOffset < header_size || indexOffset > size || (size - indexOffset) % index_entry_size != 0
+        || (size - indexOffset) / index_entry_size != mBlockCount)
+    {
+        throw std::runtime_error(__FUNCTION__ ": corrupted binary trace header.");
+    }
+
+    mIndex = mData + indexOffset;
+    uint64_t previous = header_size;
+    for (uint64_t i = 0; i < mBlockCount; ++i)
+    {
+        uint64_t offset = block(i).offset;
+        if (offset < previous || offset > indexOffset)
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted binary trace index.");
+        }
+        previous = offset;
+    }
+
+    mJob = 0;
+    mCurrent = mBlockEnd = mIndex;
+    mLastSubmitTick = 0;
+}
+
+binary_trace_block binary_trace_reader::block(uint64_t index) const noexcept
+{
+    const unsigned char* entry = mIndex + index * index_entry_size;
+    return { get_u64(entry), get_u64(entry + 8) };
+}
+
+void binary_trace_reader::enter_block(uint64_t index)
+{
+    binary_trace_block current = block(index);
+    mJob = index * mBlockSize;
+    mCurrent = mData + current.offset;
+    mBlockEnd = index + 1 < mBlockCount ? mData + block(index + 1).offset : mIndex;
+    mLastSubmitTick = current.firstSubmitTick;
+}
+
+bool binary_trace_reader::next(trace_job& job)
+{
+    if (mJob == mJobCount)
+    {
+        return false;
+    }
+
+    if (mJob % mBlockSize == 0)
+    {
+        enter_block(mJob / mBlockSize);
+    }
+
+    job.submitTick = unzigzag(mLastSubmitTick, get_varint(mCurrent, mBlockEnd));
+    job.processors = get_varint(mCurrent, mBlockEnd);
+    job.runTime = get_varint(mCurrent, mBlockEnd);
+    job.requestedTime = unzigzag(job.runTime, get_varint(mCurrent, mBlockEnd));
+    job.userId = mVersion >= 2 ? get_varint(mCurrent, mBlockEnd) : 0;
+    mLastSubmitTick = job.submitTick;
+    ++mJob;
+    return true;
+}
+
+void binary_trace_reader::seek_block(uint64_t index)
+{
+    if (index > mBlockCount)
+    {
+        throw std::out_of_range(__FUNCTION__ ": block index is out of range.");
+    }
+
+    if (index == mBlockCount)
+    {
+        mJob = mJobCount;
+        return;
+    }
+
+    enter_block(index);
+}
+
+void binary_trace_reader::seek(uint64_t submitTick)
+{
+    uint64_t left = 0;
+    uint64_t right = mBlockCount;
+    while (left < right)
+    {
+        uint64_t middle = left + (right - left) / 2;
+        if (block(middle).firstSubmitTick < submitTick)
+        {
+            left = middle + 1;
+        } else
+        {
+            right = middle;
+        }
+    }
+
+    seek_block(left > 0 ? left - 1 : 0);
+
+    trace_job job;
+    while (mJob < mJobCount)
+    {
+        const unsigned char* current = mCurrent;
+        uint64_t lastSubmitTick = mLastSubmitTick;
+        uint64_t position = mJob;
+        next(job);
+        if (job.submitTick >= submitTick)
+        {
+            mCurrent = current;
+            mLastSubmitTick = lastSubmitTick;
+            mJob = position;
+            return;
+        }
+    }
+}
\ No newline at end of file
@@ -1,11 +1,25 @@
 #include "cluster_statistics.h"
 
+std::ostream& operator<<(std::ostream& ostr, const latency_summary& summary)
+{
+    ostr << "mean " << summary.mean
+        << ", p50 " << summary.p50
+        << ", p90 " << summary.p90
+        << ", p99 " << summary.p99
+        << ", max " << summary.max;
+    return ostr;
+}
+
 std::ostream& operator<<(std::ostream& ostr, const cluster_statistics& stats)
 {
     ostr << "Ticks: " << stats.ticks()
         << "\nAdded programs: " << stats.programs_added()
         << "\nStarted programs: " << stats.programs_started()
         << "\nDone programs: " << stats.programs_done()
-        << "\nAverage load: " << stats.average_load() * 100.0 << "%";
+        << "\nKilled programs: " << stats.programs_killed()
+        << "\nAverage load: " << stats.average_load() * 100.0 << "%"
+        << "\nWait time: " << stats.wait_time()
+        << "\nTurnaround time: " << stats.turnaround_time()
+        << "\nBounded slowdown: " << stats.bounded_slowdown();
     return ostr;
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "csv_trace_reader.h"
+#include <cstring>
+#include <stdexcept>
+#include "trace_parse.h"
+
+csv_trace_reader::csv_trace_reader(const std::string& path) : mFile(std::in_place, path), mLine(0)
+{
+    mCurrent = mFile->data();
+    mEnd = mFile->data() + mFile->size();
+}
+
+csv_trace_reader::csv_trace_reader(const char* data, size_t size) : mCurrent(data), mEnd(data + size), mLine(0) {}
+
+void csv_trace_reader::parse_line(const char* begin, const char* end, trace_job& job)
+{
+    int64_t fields[3];
+    const char* cur = begin;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (i > 0)
+        {
+            while (cur < end && is_trace_space(*cur))
+            {
+                ++cur;
+            }
+            if (cur == end || *cur != ',')
+            {
+                throw std::runtime_error(std::string(__FUNCTION__) + ": malformed CSV record at line " + std::to_string(mLine) + ".");
+            }
+            ++cur;
+        }
+
+        if (!parse_trace_number(cur, end, fields[i], ',') || fields[i] < 0)
+        {
+            throw std::runtime_error(std::string(__FUNCTION__) + ": malformed CSV record at line " + std::to_string(mLine) + ".");
+        }
+    }
+
+    if (fields[1] == 0)
+    {
+        throw std::runtime_error(std::string(__FUNCTION__) + ": job at line " + std::to_string(mLine) + " requires no processors.");
+    }
+
+    job.submitTick = (uint64_t)fields[0];
+    job.processors = (uint64_t)fields[1];
+    job.runTime = (uint64_t)fields[2];
+    job.requestedTime = job.runTime;
+    job.userId = 0;
+}
+
+bool csv_trace_reader::next(trace_job& job)
+{
+    while (mCurrent < mEnd)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(mCurrent, '\n', mEnd - mCurrent));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = mEnd;
+        }
+
+        const char* begin = mCurrent;
+        mCurrent = lineEnd < mEnd ? lineEnd + 1 : mEnd;
+        ++mLine;
+
+        while (begin < lineEnd && is_trace_space(*begin))
+        {
+            ++begin;
+        }
+        if (begin == lineEnd || *begin == '#' || (mLine == 1 && (*begin < '0' || *begin > '9')))
+        {
+            continue;
+        }
+
+        parse_line(begin, lineEnd, job);
+        return true;
+    }
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "latency_histogram.h"
+#include <cmath>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    uint64_t highest_bit(uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+}
+
+// Values below sub_bucket_count are counted exactly; above that every power-of-two range
+// is split into sub_bucket_count / 2 equal buckets, which bounds the relative error by 1/64.
+size_t latency_histogram::bucket_index(uint64_t value) noexcept
+{
+    if (value < sub_bucket_count)
+    {
+        return (size_t)value;
+    }
+
+    const uint64_t shift = highest_bit(value) - sub_bucket_bits + 1;
+    const uint64_t half = sub_bucket_count / 2;
+    return (size_t)(sub_bucket_count + (shift - 1) * half + ((value >> shift) - half));
+}
+
+uint64_t latency_histogram::bucket_highest_value(size_t index) noexcept
+{
+    if (index < sub_bucket_count)
+    {
+        return index;
+    }
+
+    const uint64_t half = sub_bucket_count / 2;
+    const uint64_t shift = (index - sub_bucket_count) / half + 1;
+    const uint64_t sub = (index - sub_bucket_count) % half + half;
+    return ((sub + 1) << shift) - 1;
+}
+
+void latency_histogram::record(uint64_t value)
+{
+    const size_t index = bucket_index(value);
+    if (index >= mCounts.size())
+    {
+        mCounts.resize(index + 1, 0);
+    }
+
+    ++mCounts[index];
+    ++mCount;
+    mSum += (double)value;
+    if (value > mMax)
+    {
+        mMax = value;
+    }
+}
+
+void latency_histogram::merge(const latency_histogram& other)
+{
+    if (other.mCounts.size() > mCounts.size())
+    {
+        mCounts.resize(other.mCounts.size(), 0);
+    }
+
+    for (size_t i = 0; i < other.mCounts.size(); ++i)
+    {
+        mCounts[i] += other.mCounts[i];
+    }
+    mCount += other.mCount;
+    mSum += other.mSum;
+    if (other.mMax > mMax)
+    {
+        mMax = other.mMax;
+    }
+}
+
+uint64_t latency_histogram::value_at_quantile(double quantile) const
+{
+    if (quantile < 0.0 || quantile > 1.0)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": quantile must be in [0, 1].");
+    }
+
+    if (mCount == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)std::ceil(quantile * mCount);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < mCounts.size(); ++i)
+    {
+        seen += mCounts[i];
+        if (seen >= rank)
+        {
+            const uint64_t value = bucket_highest_value(i);
+            return value < mMax ? value : mMax;
+        }
+    }
+
+    return mMax;
+}
+
+latency_summary latency_histogram::summary(double scale) const
+{
+    return {
+        mean() / scale,
+        value_at_quantile(0.5) / scale,
+        value_at_quantile(0.9) / scale,
+        value_at_quantile(0.99) / scale,
+        mMax / scale
+    };
+}
+
+void latency_histogram::save(binary_writer& writer) const
+{
+    writer.write(mCounts);
+    writer.write(mCount);
+    writer.write(mMax);
+    writer.write(mSum);
+}
+
+void latency_histogram::load(binary_reader& reader)
+{
+    reader.read(mCounts);
+    reader.read(mCount);
+    reader.read(mMax);
+    reader.read(mSum);
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "load_timeline.h"
+#include <stdexcept>
+
+namespace
+{
+    timeline_bucket empty_bucket(uint64_t tickStart)
+    {
+        return { tickStart, 0, UINT64_MAX, 0, 0.0, UINT64_MAX, 0, 0.0 };
+    }
+
+    void add_samples(timeline_bucket& bucket, uint64_t load, uint64_t queued, uint64_t ticks)
+    {
+        bucket.ticks += ticks;
+        bucket.loadMin = load < bucket.loadMin ? load : bucket.loadMin;
+        bucket.loadMax = load > bucket.loadMax ? load : bucket.loadMax;
+        bucket.loadSum += (double)load * ticks;
+        bucket.queueMin = queued < bucket.queueMin ? queued : bucket.queueMin;
+        bucket.queueMax = queued > bucket.queueMax ? queued : bucket.queueMax;
+        bucket.queueSum += (double)queued * ticks;
+    }
+
+    void merge(timeline_bucket& bucket, const timeline_bucket& other)
+    {
+        bucket.ticks += other.ticks;
+        bucket.loadMin = other.loadMin < bucket.loadMin ? other.loadMin : bucket.loadMin;
+        bucket.loadMax = other.loadMax > bucket.loadMax ? other.loadMax : bucket.loadMax;
+        bucket.loadSum += other.loadSum;
+        bucket.queueMin = other.queueMin < bucket.queueMin ? other.queueMin : bucket.queueMin;
+        bucket.queueMax = other.queueMax > bucket.queueMax ? other.queueMax : bucket.queueMax;
+        bucket.queueSum += other.queueSum;
+    }
+}
+
+load_timeline::load_timeline(size_t bucketCount, size_t levels, uint64_t factor)
+    : mOverviewCurrent(empty_bucket(1)), mOverviewWidth(1), mBucketCount(bucketCount), mTick(1)
+{
+    if (bucketCount < 2)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": timeline must keep at least two buckets per level.");
+    }
+
+    if (factor < 2)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": resolution factor must be at least two.");
+    }
+
+    uint64_t width = 1;
+    for (size_t i = 0; i < levels; ++i)
+    {
+        mLevels.push_back({ width, {}, 0, empty_bucket(1) });
+        width *= factor;
+    }
+}
+
+void load_timeline::append(level& l, uint64_t load, uint64_t queued, uint64_t ticks)
+{
+    while (ticks > 0)
+    {
+        const uint64_t taken = l.width - l.current.ticks < ticks ? l.width - l.current.ticks : ticks;
+        add_samples(l.current, load, queued, taken);
+        ticks -= taken;
+
+        if (l.current.ticks == l.width)
+        {
+            const uint64_t next = l.current.tickStart + l.width;
+            if (l.buckets.size() < mBucketCount)
+            {
+                l.buckets.push_back(l.current);
+            } else
+            {
+                l.buckets[l.head] = l.current;
+                l.head = (l.head + 1) % mBucketCount;
+            }
+
+            // Buckets that would be pushed out again before the run ends are never stored.
+            const uint64_t skipped = ticks / l.width > mBucketCount ? (ticks / l.width - mBucketCount) * l.width : 0;
+            ticks -= skipped;
+            l.current = empty_bucket(next + skipped);
+        }
+    }
+}
+
+void load_timeline::compact_overview()
+{
+    for (size_t i = 0; i < mOverview.size() / 2; ++i)
+    {
+        timeline_bucket bucket = mOverview[2 * i];
+        merge(bucket, mOverview[2 * i + 1]);
+        mOverview[i] = bucket;
+    }
+
+    if (mOverview.size() % 2 == 1)
+    {
+        timeline_bucket bucket = mOverview.back();
+        merge(bucket, mOverviewCurrent);
+        mOverviewCurrent = bucket;
+    }
+
+    mOverview.resize(mOverview.size() / 2);
+    mOverviewWidth *= 2;
+}
+
+void load_timeline::append_overview(uint64_t load, uint64_t queued, uint64_t ticks)
+{
+    while (ticks > 0)
+    {
+        const uint64_t taken = mOverviewWidth - mOverviewCurrent.ticks < ticks ? mOverviewWidth - mOverviewCurrent.ticks : ticks;
+        add_samples(mOverviewCurrent, load, queued, taken);
+        ticks -= taken;
+
+        if (mOverviewCurrent.ticks == mOverviewWidth)
+        {
+            mOverview.push_back(mOverviewCurrent);
+            mOverviewCurrent = empty_bucket(mOverviewCurrent.tickStart + mOverviewWidth);
+            if (mOverview.size() == mBucketCount)
+            {
+                compact_overview();
+            }
+        }
+    }
+}
+
+void load_timeline::record(uint64_t load, uint64_t queued, uint64_t ticks)
+{
+    if (ticks == 0)
+    {
+        return;
+    }
+
+    for (level& l : mLevels)
+    {
+        append(l, load, queued, ticks);
+    }
+    append_overview(load, queued, ticks);
+    mTick += ticks;
+}
+
+std::vector<timeline_bucket> load_timeline::buckets(size_t level) const
+{
+    if (level > mLevels.size())
+    {
+        throw std::out_of_range(__FUNCTION__ ": timeline level is out of range.");
+    }
+
+    std::vector<timeline_bucket> result;
+    if (level == mLevels.size())
+    {
+        result = mOverview;
+        if (mOverviewCurrent.ticks > 0)
+        {
+            result.push_back(mOverviewCurrent);
+        }
+        return result;
+    }
+
+    const load_timeline::level& l = mLevels[level];
+    result.reserve(l.buckets.size() + 1);
+    for (size_t i = 0; i < l.buckets.size(); ++i)
+    {
+        result.push_back(l.buckets[(l.head + i) % l.buckets.size()]);
+    }
+    if (l.current.ticks > 0)
+    {
+        result.push_back(l.current);
+    }
+    return result;
+}
+
+uint64_t load_timeline::bucket_width(size_t level) const
+{
+    if (level > mLevels.size())
+    {
+        throw std::out_of_range(__FUNCTION__ ": timeline level is out of range.");
+    }
+
+    return level == mLevels.size() ? mOverviewWidth : mLevels[level].width;
+}
+
+void load_timeline::write_csv(std::ostream& ostr, size_t level) const
+{
+    ostr << "tick_start,ticks,load_min,load_mean,load_max,queue_min,queue_mean,queue_max\n";
+    for (const timeline_bucket& bucket : buckets(level))
+    {
+        ostr << bucket.tickStart << ',' << bucket.ticks << ','
+            << bucket.loadMin << ',' << bucket.load_mean() << ',' << bucket.loadMax << ','
+            << bucket.queueMin << ',' << bucket.queue_mean() << ',' << bucket.queueMax << '\n';
+    }
+}
+
+void load_timeline::save(binary_writer& writer) const
+{
+    writer.write(mBucketCount);
+    writer.write(mTick);
+    writer.write<uint64_t>(mLevels.size());
+    for (const level& l : mLevels)
+    {
+        writer.write(l.width);
+        writer.write(l.buckets);
+        writer.write(l.head);
+        writer.write(l.current);
+    }
+    writer.write(mOverview);
+    writer.write(mOverviewCurrent);
+    writer.write(mOverviewWidth);
+}
+
+void load_timeline::load(binary_reader& reader)
+{
+    reader.read(mBucketCount);
+    reader.read(mTick);
+    const uint64_t levels = reader.read<uint64_t>();
+    if (mBucketCount < 2 || levels > 64)
+    {
+        throw std::runtime_error(__FUNCTION__ ": corrupted timeline snapshot.");
+    }
+
+    mLevels.resize(levels);
+    for (level& l : mLevels)
+    {
+        reader.read(l.width);
+        reader.read(l.buckets);
+        reader.read(l.head);
+        reader.read(l.current);
+        if (l.width == 0 || l.buckets.size() > mBucketCount || (l.head != 0 && l.head >= l.buckets.size()))
+        {
+            throw std::runtime_error(__FUNCTION__ ": corrupted timeline snapshot.");
+        }
+    }
+    reader.read(mOverview);
+    reader.read(mOverviewCurrent);
+    reader.read(mOverviewWidth);
+    if (mOverview.size() >= mBucketCount || mOverviewWidth == 0)
+    {
+        throw std::runtime_error(__FUNCTION__ ": corrupted timeline snapshot.");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "mapped_file.h"
+#include <stdexcept>
+#include <utility>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+mapped_file::mapped_file(const std::string& path) : mData(nullptr), mSize(0), mFile(nullptr), mMapping(nullptr)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't open file " + path + ".");
+    }
+    mFile = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        close();
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't get size of file " + path + ".");
+    }
+
+    mSize = (size_t)size.QuadPart;
+    if (mSize == 0)
+    {
+        return;
+    }
+
+    mMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr)
+    {
+        close();
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't map file " + path + ".");
+    }
+
+    mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData == nullptr)
+    {
+        close();
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't map file " + path + ".");
+    }
+}
+
+void mapped_file::close() noexcept
+{
+    if (mData != nullptr) UnmapViewOfFile(mData);
+    if (mMapping != nullptr) CloseHandle(mMapping);
+    if (mFile != nullptr) CloseHandle(mFile);
+
+    mData = nullptr;
+    mMapping = nullptr;
+    mFile = nullptr;
+    mSize = 0;
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : mData(std::exchange(other.mData, nullptr)), mSize(std::exchange(other.mSize, 0)),
+    mFile(std::exchange(other.mFile, nullptr)), mMapping(std::exchange(other.mMapping, nullptr))
+{}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+        mFile = std::exchange(other.mFile, nullptr);
+        mMapping = std::exchange(other.mMapping, nullptr);
+    }
+
+    return *this;
+}
+#else
+mapped_file::mapped_file(const std::string& path) : mData(nullptr), mSize(0), mFile(-1)
+{
+    mFile = ::open(path.c_str(), O_RDONLY);
+    if (mFile < 0)
+    {
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't open file " + path + ".");
+    }
+
+    struct stat info;
+    if (::fstat(mFile, &info) != 0)
+    {
+        close();
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't get size of file " + path + ".");
+    }
+
+    mSize = (size_t)info.st_size;
+    if (mSize == 0)
+    {
+        return;
+    }
+
+    void* data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+    if (data == MAP_FAILED)
+    {
+        close();
+        throw std::runtime_error(std::string(__FUNCTION__) + ": can't map file " + path + ".");
+    }
+
+    mData = static_cast<const char*>(data);
+    ::madvise(data, mSize, MADV_SEQUENTIAL);
+}
+
+void mapped_file::close() noexcept
+{
+    if (mData != nullptr) ::munmap(const_cast<char*>(mData), mSize);
+    if (mFile >= 0) ::close(mFile);
+
+    mData = nullptr;
+    mFile = -1;
+    mSize = 0;
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : mData(std::exchange(other.mData, nullptr)), mSize(std::exchange(other.mSize, 0)), mFile(std::exchange(other.mFile, -1))
+{}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+        mFile = std::exchange(other.mFile, -1);
+    }
+
+    return *this;
+}
+#endif
+
+mapped_file::~mapped_file()
+{
+    close();
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "partitioned_cluster.h"
+#include <stdexcept>
+#include "latency_histogram.h"
+
+partitioned_cluster::partitioned_cluster(const std::vector<partition_config>& partitions,
+    const scheduler_registry& registry, size_t threads, uint64_t syncInterval, bool borrowing)
+    : mSyncInterval(syncInterval), mBorrowing(borrowing), mCurrentTick(0)
+{
+    if (partitions.empty())
+    {
+        throw std::invalid_argument(__FUNCTION__ ": cluster needs at least one partition.");
+    }
+
+    if (syncInterval < 1)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": sync interval must be positive.");
+    }
+
+    for (const partition_config& config : partitions)
+    {
+        for (const partition& other : mPartitions)
+        {
+            if (other.config.name == config.name)
+            {
+                throw std::invalid_argument(std::string(__FUNCTION__) + ": duplicate partition " + config.name + ".");
+            }
+        }
+
+        mPartitions.push_back({ config, registry.create(config.policy, config.processors), partition_usage{} });
+    }
+
+    if (threads > 1 && mPartitions.size() > 1)
+    {
+        mPool = std::make_unique<thread_pool>(threads);
+    }
+}
+
+size_t partitioned_cluster::partition_index(const std::string& name) const
+{
+    for (size_t i = 0; i < mPartitions.size(); ++i)
+    {
+        if (mPartitions[i].config.name == name)
+        {
+            return i;
+        }
+    }
+
+    throw std::invalid_argument(std::string(__FUNCTION__) + ": unknown partition " + name + ".");
+}
+
+void partitioned_cluster::add_program(size_t partition, const program_info& info)
+{
+    mPartitions.at(partition).simulator->add_program(info);
+}
+
+void partitioned_cluster::add_programs(size_t partition, const program_info* programs, size_t count)
+{
+    mPartitions.at(partition).simulator->add_programs(programs, count);
+}
+
+template<typename F>
+void partitioned_cluster::for_each_partition(F f)
+{
+    if (!mPool)
+    {
+        for (partition& p : mPartitions)
+        {
+            f(*p.simulator);
+        }
+        return;
+    }
+
+    for (partition& p : mPartitions)
+    {
+        cluster_simulator* simulator = p.simulator.get();
+        mPool->submit([simulator, f]() { f(*simulator); });
+    }
+    mPool->wait();
+}
+
+void partitioned_cluster::run_partitions(uint64_t targetTick)
+{
+    for_each_partition([targetTick](cluster_simulator& simulator) { simulator.run_until(targetTick); });
+}
+
+// Runs on one thread between begin_tick and end_tick of every partition, so the outcome doesn't
+// depend on how the partitions were scheduled and adopted programs count towards this tick.
+void partitioned_cluster::borrow_processors()
+{
+    for (partition& borrower : mPartitions)
+    {
+        if (!borrower.config.borrows)
+        {
+            continue;
+        }
+
+        for (partition& lender : mPartitions)
+        {
+            if (&lender == &borrower || !lender.config.lends)
+            {
+                continue;
+            }
+
+            while (borrower.simulator->waiting_programs() > 0 && lender.simulator->waiting_programs() == 0
+                && lender.simulator->free_processors() > 0)
+            {
+                auto program = borrower.simulator->migrate_program(lender.simulator->state());
+                if (!program.has_value())
+                {
+                    break;
+                }
+
+                lender.simulator->adopt_program(program.value().first, program.value().second);
+
+                const uint64_t processorTicks = program.value().second.processors * program.value().second.run_time();
+                ++lender.usage.programsLent;
+                ++borrower.usage.programsBorrowed;
+                lender.usage.processorTicksLent += processorTicks;
+                borrower.usage.processorTicksBorrowed += processorTicks;
+            }
+        }
+    }
+}
+
+void partitioned_cluster::tick()
+{
+    run_until(mCurrentTick + 1);
+}
+
+void partitioned_cluster::run_until(uint64_t targetTick)
+{
+    while (mCurrentTick < targetTick)
+    {
+        const uint64_t sync = (mCurrentTick / mSyncInterval + 1) * mSyncInterval;
+        if (!mBorrowing || targetTick < sync)
+        {
+            run_partitions(targetTick);
+            mCurrentTick = targetTick;
+            break;
+        }
+
+        for_each_partition([sync](cluster_simulator& simulator)
+        {
+            simulator.run_until(sync - 1);
+            simulator.begin_tick();
+        });
+        borrow_processors();
+        for (partition& p : mPartitions)
+        {
+            p.simulator->end_tick();
+        }
+        mCurrentTick = sync;
+    }
+}
+
+cluster_statistics partitioned_cluster::get_statistics(size_t partition)
+{
+    cluster_simulator& simulator = *mPartitions.at(partition).simulator;
+    cluster_statistics stats = simulator.get_statistics();
+    return cluster_statistics(
+        stats.programs_added() - simulator.programs_migrated(),
+        stats.programs_done(),
+        stats.programs_started(),
+
+        stats.ticks(),
+        stats.average_load(),
+
+        stats.wait_time(),
+        stats.turnaround_time(),
+        stats.bounded_slowdown(),
+        stats.programs_killed()
+    );
+}
+
+cluster_statistics partitioned_cluster::get_statistics()
+{
+    uint64_t added = 0;
+    uint64_t done = 0;
+    uint64_t started = 0;
+    uint64_t killed = 0;
+    double load = 0;
+    latency_histogram waitTime;
+    latency_histogram turnaroundTime;
+    latency_histogram boundedSlowdown;
+
+    for (size_t i = 0; i < mPartitions.size(); ++i)
+    {
+        const partition& p = mPartitions[i];
+        cluster_statistics stats = get_statistics(i);
+        added += stats.programs_added();
+        done += stats.programs_done();
+        started += stats.programs_started();
+        killed += stats.programs_killed();
+        load += stats.average_load() * p.simulator->processors();
+
+        waitTime.merge(p.simulator->wait_times());
+        turnaroundTime.merge(p.simulator->turnaround_times());
+        boundedSlowdown.merge(p.simulator->bounded_slowdowns());
+    }
+
+    return cluster_statistics(
+        added,
+        done,
+        started,
+
+        mCurrentTick,
+        load / processors(),
+
+        waitTime.summary(),
+        turnaroundTime.summary(),
+        boundedSlowdown.summary(cluster_statistics::slowdown_scale),
+        killed
+    );
+}
+
+uint64_t partitioned_cluster::processors() const noexcept
+{
+    uint64_t res = 0;
+    for (const partition& p : mPartitions)
+    {
+        res += p.simulator->processors();
+    }
+    return res;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "scenario_sweep.h"
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include "thread_pool.h"
+#include "basic_queue.h"
+#include "priority_queue.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
+
+std::map<std::string, sweep_simulation> default_sweep_policies()
+{
+    return {
+        { "basic", &simulate_scenario<basic_queue> },
+        { "priority:10", &simulate_scenario<priority_queue<10>> },
+        { "priority:100", &simulate_scenario<priority_queue<100>> },
+        { "priority:1000", &simulate_scenario<priority_queue<1000>> },
+        { "planning:10", &simulate_scenario<planning_queue<10>> },
+        { "planning:100", &simulate_scenario<planning_queue<100>> },
+        { "easy:100", &simulate_scenario<easy_backfill_queue<100>> },
+        { "conservative:100", &simulate_scenario<conservative_backfill_queue<100>> },
+    };
+}
+
+static std::vector<sweep_result> run_simulations(const std::vector<sweep_scenario>& scenarios,
+    const std::vector<std::function<cluster_statistics(const sweep_scenario&)>>& simulations, size_t threads)
+{
+    std::vector<std::optional<cluster_statistics>> statistics(scenarios.size());
+    {
+        thread_pool pool(threads);
+        for (size_t i = 0; i < scenarios.size(); ++i)
+        {
+            pool.submit([&, i]() { statistics[i] = simulations[i](scenarios[i]); });
+        }
+        pool.wait();
+    }
+
+    std::vector<sweep_result> results;
+    results.reserve(scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); ++i)
+    {
+        results.push_back({ scenarios[i], statistics[i].value() });
+    }
+
+    return results;
+}
+
+std::vector<sweep_result> run_sweep(const std::vector<sweep_scenario>& scenarios,
+    const std::map<std::string, sweep_simulation>& policies, size_t threads)
+{
+    std::vector<std::function<cluster_statistics(const sweep_scenario&)>> simulations;
+    for (const auto& scenario : scenarios)
+    {
+        auto policy = policies.find(scenario.policy);
+        if (policy == policies.end())
+        {
+            throw std::invalid_argument(std::string(__FUNCTION__) + ": unknown policy " + scenario.policy + ".");
+        }
+        if (scenario.processors < 1)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": cluster must have at least one processor.");
+        }
+
+        simulations.push_back(policy->second);
+    }
+
+    return run_simulations(scenarios, simulations, threads);
+}
+
+std::vector<sweep_result> run_sweep(const std::vector<sweep_scenario>& scenarios,
+    const scheduler_registry& registry, size_t threads)
+{
+    std::vector<std::function<cluster_statistics(const sweep_scenario&)>> simulations;
+    for (const auto& scenario : scenarios)
+    {
+        registry.parse(scenario.policy);
+        if (scenario.processors < 1)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": cluster must have at least one processor.");
+        }
+
+        simulations.push_back([&registry](const sweep_scenario& s)
+        {
+            std::unique_ptr<cluster_simulator> simulator = registry.create(s.policy, s.processors);
+            return drive_scenario(s, *simulator);
+        });
+    }
+
+    return run_simulations(scenarios, simulations, threads);
+}
+
+void print_sweep_table(std::ostream& ostr, const std::vector<sweep_result>& results)
+{
+    ostr << std::left << std::setw(28) << "Policy"
+        << std::right << std::setw(12) << "Processors"
+        << std::setw(10) << "Rate"
+        << std::setw(8) << "Seed"
+        << std::setw(12) << "Ticks"
+        << std::setw(12) << "Added"
+        << std::setw(12) << "Started"
+        << std::setw(12) << "Done"
+        << std::setw(10) << "Load"
+        << std::setw(12) << "Mean wait"
+        << std::setw(12) << "p99 wait" << "\n";
+
+    for (const auto& result : results)
+    {
+        const sweep_scenario& s = result.scenario;
+        const cluster_statistics& stats = result.statistics;
+        ostr << std::left << std::setw(28) << s.policy
+            << std::right << std::setw(12) << s.processors
+            << std::setw(10) << s.arrivalRate
+            << std::setw(8) << s.seed
+            << std::setw(12) << stats.ticks()
+            << std::setw(12) << stats.programs_added()
+            << std::setw(12) << stats.programs_started()
+            << std::setw(12) << stats.programs_done()
+            << std::setw(9) << std::fixed << std::setprecision(2) << stats.average_load() * 100.0 << "%"
+            << std::setw(12) << stats.wait_time().mean
+            << std::setw(12) << stats.wait_time().p99
+            << std::defaultfloat << std::setprecision(6) << "\n";
+    }
+}
\ No newline at end of file
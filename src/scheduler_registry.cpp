@@ -0,0 +1,149 @@
+#include "scheduler_registry.h"
+#include <algorithm>
+#include <stdexcept>
+#include "basic_queue.h"
+#include "priority_queue.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
+#include "heap_queue.h"
+#include "fair_share_queue.h"
+#include "cow_deque.h"
+
+static uint64_t parse_parameter_value(const std::string& text)
+{
+    if (text == "inf")
+    {
+        return UINT64_MAX;
+    }
+
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+    {
+        throw std::invalid_argument(std::string(__FUNCTION__) + ": invalid parameter value " + text + ".");
+    }
+
+    uint64_t value = 0;
+    for (char c : text)
+    {
+        const uint64_t digit = (uint64_t)(c - '0');
+        if (value > (UINT64_MAX - digit) / 10)
+        {
+            throw std::invalid_argument(std::string(__FUNCTION__) + ": parameter value is too large " + text + ".");
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+std::vector<std::string> scheduler_registry::names() const
+{
+    std::vector<std::string> res;
+    for (const auto& e : mEntries)
+    {
+        res.push_back(e.first);
+    }
+    return res;
+}
+
+scheduler_spec scheduler_registry::parse(const std::string& text) const
+{
+    scheduler_spec spec;
+    const size_t colon = text.find(':');
+    spec.name = text.substr(0, colon);
+
+    auto e = mEntries.find(spec.name);
+    if (e == mEntries.end())
+    {
+        throw std::invalid_argument(std::string(__FUNCTION__) + ": unknown policy " + spec.name + ".");
+    }
+
+    if (colon == std::string::npos)
+    {
+        return spec;
+    }
+
+    const std::vector<std::string>& known = e->second.parameters;
+    size_t begin = colon + 1;
+    for (;;)
+    {
+        const size_t end = text.find(',', begin);
+        const std::string item = text.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        const size_t equals = item.find('=');
+
+        std::string key;
+        if (equals == std::string::npos)
+        {
+            if (known.empty() || !spec.parameters.empty())
+            {
+                throw std::invalid_argument(std::string(__FUNCTION__) + ": unnamed parameter in " + text + ".");
+            }
+            key = known.front();
+        } else
+        {
+            key = item.substr(0, equals);
+        }
+
+        if (std::find(known.begin(), known.end(), key) == known.end())
+        {
+            throw std::invalid_argument(std::string(__FUNCTION__) + ": unknown parameter " + key + " of policy " + spec.name + ".");
+        }
+
+        if (!spec.parameters.emplace(key, parse_parameter_value(equals == std::string::npos ? item : item.substr(equals + 1))).second)
+        {
+            throw std::invalid_argument(std::string(__FUNCTION__) + ": parameter " + key + " is set twice.");
+        }
+
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        begin = end + 1;
+    }
+
+    return spec;
+}
+
+std::unique_ptr<cluster_simulator> scheduler_registry::create(const std::string& spec, uint64_t processors) const
+{
+    const scheduler_spec parsed = parse(spec);
+    return mEntries.at(parsed.name).make(processors, parsed);
+}
+
+// The list queues keep their programs in cow_deque, so fork() shares them until either side writes.
+static scheduler_registry make_default_registry()
+{
+    using basic = fifo_queue<cow_deque>;
+    using priority = priority_queue<0, cow_deque>;
+    using planning = planning_queue<UINT64_MAX, cow_deque>;
+    using easy = easy_backfill_queue<UINT64_MAX, cow_deque>;
+    using conservative = conservative_backfill_queue<UINT64_MAX, cow_deque>;
+
+    scheduler_registry registry;
+    registry.add<basic>("basic", {},
+        [](const scheduler_spec&) { return basic(); });
+    registry.add<priority>("priority", { "maxdelay" },
+        [](const scheduler_spec& spec) { return priority(spec.parameter("maxdelay", 0)); });
+    registry.add<planning>("planning", { "lookahead" },
+        [](const scheduler_spec& spec) { return planning(spec.parameter("lookahead", UINT64_MAX)); });
+    registry.add<easy>("easy", { "lookahead" },
+        [](const scheduler_spec& spec) { return easy(spec.parameter("lookahead", UINT64_MAX)); });
+    registry.add<conservative>("conservative", { "lookahead" },
+        [](const scheduler_spec& spec) { return conservative(spec.parameter("lookahead", UINT64_MAX)); });
+    registry.add<sjf_queue<>>("sjf", { "aging" },
+        [](const scheduler_spec& spec) { return sjf_queue<>(spec.parameter("aging", 0)); });
+    registry.add<ljf_queue<>>("ljf", { "aging" },
+        [](const scheduler_spec& spec) { return ljf_queue<>(spec.parameter("aging", 0)); });
+    registry.add<smallest_area_queue<>>("area", { "aging" },
+        [](const scheduler_spec& spec) { return smallest_area_queue<>(spec.parameter("aging", 0)); });
+    registry.add<widest_first_queue<>>("widest", { "aging" },
+        [](const scheduler_spec& spec) { return widest_first_queue<>(spec.parameter("aging", 0)); });
+    registry.add<fair_share_queue<>>("fairshare", { "halflife" },
+        [](const scheduler_spec& spec) { return fair_share_queue<>(spec.parameter("halflife", 1000)); });
+    return registry;
+}
+
+const scheduler_registry& default_scheduler_registry()
+{
+    static const scheduler_registry registry = make_default_registry();
+    return registry;
+}
\ No newline at end of file
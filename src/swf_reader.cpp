@@ -0,0 +1,89 @@
+#include "swf_reader.h"
+#include <cstring>
+#include <stdexcept>
+#include "trace_parse.h"
+
+namespace
+{
+    const int swf_fields = 18;
+
+    enum swf_field
+    {
+        submit_time = 1,
+        run_time = 3,
+        allocated_processors = 4,
+        requested_processors = 7,
+        requested_time = 8,
+        user_id = 11
+    };
+}
+
+swf_reader::swf_reader(const std::string& path) : mFile(std::in_place, path), mLine(0), mSkipped(0)
+{
+    mCurrent = mFile->data();
+    mEnd = mFile->data() + mFile->size();
+}
+
+swf_reader::swf_reader(const char* data, size_t size) : mCurrent(data), mEnd(data + size), mLine(0), mSkipped(0) {}
+
+bool swf_reader::parse_line(const char* begin, const char* end, trace_job& job)
+{
+    int64_t fields[swf_fields];
+    const char* cur = begin;
+    int count = 0;
+    while (count < swf_fields && parse_trace_number(cur, end, fields[count]))
+    {
+        ++count;
+    }
+
+    if (count <= requested_time)
+    {
+        throw std::runtime_error(std::string(__FUNCTION__) + ": malformed SWF record at line " + std::to_string(mLine) + ".");
+    }
+
+    int64_t processors = fields[allocated_processors] > 0 ? fields[allocated_processors] : fields[requested_processors];
+    if (fields[submit_time] < 0 || fields[run_time] < 0 || processors <= 0)
+    {
+        return false;
+    }
+
+    job.submitTick = (uint64_t)fields[submit_time];
+    job.processors = (uint64_t)processors;
+    job.runTime = (uint64_t)fields[run_time];
+    job.requestedTime = fields[requested_time] > 0 ? (uint64_t)fields[requested_time] : job.runTime;
+    job.userId = count > user_id && fields[user_id] > 0 ? (uint64_t)fields[user_id] : 0;
+    return true;
+}
+
+bool swf_reader::next(trace_job& job)
+{
+    while (mCurrent < mEnd)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(mCurrent, '\n', mEnd - mCurrent));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = mEnd;
+        }
+
+        const char* begin = mCurrent;
+        mCurrent = lineEnd < mEnd ? lineEnd + 1 : mEnd;
+        ++mLine;
+
+        while (begin < lineEnd && (*begin == ' ' || *begin == '\t' || *begin == '\r'))
+        {
+            ++begin;
+        }
+        if (begin == lineEnd || *begin == ';')
+        {
+            continue;
+        }
+
+        if (parse_line(begin, lineEnd, job))
+        {
+            return true;
+        }
+        ++mSkipped;
+    }
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "binary_trace.h"
+#include "csv_trace_reader.h"
+#include "trace_replay.h"
+#include "basic_queue.h"
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace
+{
+    std::vector<trace_job> make_jobs(size_t count)
+    {
+        std::vector<trace_job> jobs;
+        uint64_t tick = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            tick += i % 3;
+            jobs.push_back({ tick, 1 + i % 7, (i * 37) % 500, (i * 37) % 500 + (i % 2 == 0 ? 60 : 0), i % 5 });
+        }
+        return jobs;
+    }
+
+    std::string write_trace(const std::vector<trace_job>& jobs, uint32_t blockSize)
+    {
+        std::string path = testing::TempDir() + "binary_trace_test.mp2t";
+        binary_trace_writer writer(path, blockSize);
+        for (const trace_job& job : jobs)
+        {
+            writer.write(job);
+        }
+        writer.close();
+        return path;
+    }
+
+    void expect_job_eq(const trace_job& actual, const trace_job& expected)
+    {
+        EXPECT_EQ(actual.submitTick, expected.submitTick);
+        EXPECT_EQ(actual.processors, expected.processors);
+        EXPECT_EQ(actual.runTime, expected.runTime);
+        EXPECT_EQ(actual.requestedTime, expected.requestedTime);
+        EXPECT_EQ(actual.userId, expected.userId);
+    }
+}
+
+TEST(BinaryTraceTest, can_write_and_read_jobs)
+{
+    std::vector<trace_job> jobs = make_jobs(1000);
+    std::string path = write_trace(jobs, 64);
+
+    {
+        binary_trace_reader reader(path);
+        EXPECT_EQ(reader.job_count(), jobs.size());
+        EXPECT_EQ(reader.block_count(), 16);
+
+        trace_job job;
+        for (const trace_job& expected : jobs)
+        {
+            ASSERT_TRUE(reader.next(job));
+            expect_job_eq(job, expected);
+        }
+        EXPECT_FALSE(reader.next(job));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BinaryTraceTest, can_read_empty_trace)
+{
+    std::string path = write_trace({}, 64);
+
+    {
+        binary_trace_reader reader(path);
+        trace_job job;
+        EXPECT_EQ(reader.job_count(), 0);
+        EXPECT_FALSE(reader.next(job));
+
+        reader.seek(10);
+        EXPECT_FALSE(reader.next(job));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BinaryTraceTest, can_seek_to_submit_tick)
+{
+    std::vector<trace_job> jobs = make_jobs(1000);
+    std::string path = write_trace(jobs, 50);
+
+    {
+        binary_trace_reader reader(path);
+        trace_job job;
+        for (uint64_t tick : { 0, 1, 17, 333, 500, 998, 999, 5000 })
+        {
+            size_t expected = 0;
+            while (expected < jobs.size() && jobs[expected].submitTick < tick)
+            {
+                ++expected;
+            }
+
+            reader.seek(tick);
+            EXPECT_EQ(reader.position(), expected);
+            if (expected < jobs.size())
+            {
+                ASSERT_TRUE(reader.next(job));
+                expect_job_eq(job, jobs[expected]);
+            } else
+            {
+                EXPECT_FALSE(reader.next(job));
+            }
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BinaryTraceTest, can_seek_to_block)
+{
+    std::vector<trace_job> jobs = make_jobs(100);
+    std::string path = write_trace(jobs, 30);
+
+    {
+        binary_trace_reader reader(path);
+        trace_job job;
+
+        reader.seek_block(2);
+        ASSERT_TRUE(reader.next(job));
+        expect_job_eq(job, jobs[60]);
+
+        ASSERT_ANY_THROW(reader.seek_block(5));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BinaryTraceTest, throws_on_corrupted_trace)
+{
+    std::string garbage = "definitely not a binary trace, just some text";
+    ASSERT_ANY_THROW(binary_trace_reader(garbage.data(), garbage.size()));
+
+    std::vector<trace_job> jobs = make_jobs(10);
+    std::string path = write_trace(jobs, 4);
+    std::string truncated;
+    {
+        mapped_file file(path);
+        truncated.assign(file.data(), file.size() - 20);
+    }
+    std::remove(path.c_str());
+
+    ASSERT_ANY_THROW(binary_trace_reader(truncated.data(), truncated.size()));
+}
+
+TEST(BinaryTraceTest, throws_when_job_count_does_not_match_index)
+{
+    std::vector<trace_job> jobs = make_jobs(10);
+    std::string path = write_trace(jobs, 4);
+    std::string data;
+    {
+        mapped_file file(path);
+        data.assign(file.data(), file.size());
+    }
+    std::remove(path.c_str());
+
+    for (uint64_t jobCount : { UINT64_MAX, UINT64_MAX - 2, (uint64_t)13, (uint64_t)8 })
+    {
+        std::string corrupted = data;
+        for (int i = 0; i < 8; ++i)
+        {
+            corrupted[16 + i] = (char)((jobCount >> (8 * i)) & 0xff);
+        }
+        EXPECT_THROW(binary_trace_reader(corrupted.data(), corrupted.size()), std::runtime_error);
+    }
+}
+
+TEST(BinaryTraceTest, can_convert_csv_trace)
+{
+    std::string csv =
+        "submit,processors,executionTime\n"
+        "0,2,10\n"
+        "# comment\n"
+        "0, 4, 3\r\n"
+        "5,1,0";
+    csv_trace_reader csvReader(csv.data(), csv.size());
+    std::string path = testing::TempDir() + "binary_trace_csv.mp2t";
+
+    {
+        binary_trace_writer writer(path);
+        EXPECT_EQ(convert_trace(csvReader, writer), 3);
+    }
+
+    {
+        binary_trace_reader reader(path);
+        cluster_management_system<basic_queue> cms(4);
+        trace_replay<basic_queue, binary_trace_reader> replay(cms, reader);
+
+        replay.run();
+        while (cms.advance_to_next_event()) {}
+
+        EXPECT_EQ(replay.jobs_replayed(), 3);
+        EXPECT_EQ(cms.get_statistics().programs_done(), 3);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(BinaryTraceTest, csv_reader_throws_on_malformed_record)
+{
+    std::string csv = "0,2\n";
+    csv_trace_reader reader(csv.data(), csv.size());
+    trace_job job;
+
+    ASSERT_ANY_THROW(reader.next(job));
+}
\ No newline at end of file
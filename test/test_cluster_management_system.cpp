@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
 #include "cluster_management_system.h"
+#include "ring_buffer.h"
+#include "cow_deque.h"
 #include "basic_queue.h"
 #include "planning_queue.h"
 #include "priority_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
 
 TEST(ClusterManagementSystemTest, can_create)
 {
@@ -168,4 +176,514 @@ TEST(ClusterManagementSystemTest, AverageLoadCalculation)
 
     auto stats = cms.get_statistics();
     EXPECT_DOUBLE_EQ(stats.average_load(), (2.0 + 2.0 + 1.0 + 1.0) / 8.0);
+}
+
+template<typename T>
+static cluster_statistics run_random_workload(bool eventDriven, bool earlyFinishes = false)
+{
+    std::default_random_engine g(42);
+    std::uniform_int_distribution<uint64_t> processorsDist(1, 16);
+    std::uniform_int_distribution<uint64_t> ticksDist(0, 50);
+    std::uniform_int_distribution<uint64_t> gapDist(0, 30);
+
+    cluster_management_system<T> cms(16);
+    uint64_t nextArrival = 0;
+    for (int i = 0; i < 300; ++i)
+    {
+        nextArrival += gapDist(g);
+        if (eventDriven)
+        {
+            cms.run_until(nextArrival);
+        } else
+        {
+            while (cms.current_tick() < nextArrival) cms.tick();
+        }
+
+        const uint64_t processors = processorsDist(g);
+        const uint64_t limit = ticksDist(g);
+        cms.add_program({ processors, limit, earlyFinishes ? limit / 3 : UINT64_MAX });
+    }
+
+    if (eventDriven)
+    {
+        cms.run_until(nextArrival + 10000);
+    } else
+    {
+        while (cms.current_tick() < nextArrival + 10000) cms.tick();
+    }
+
+    return cms.get_statistics();
+}
+
+template<typename T>
+static void expect_event_driven_matches_ticks(bool earlyFinishes = false)
+{
+    cluster_statistics ticked = run_random_workload<T>(false, earlyFinishes);
+    cluster_statistics skipped = run_random_workload<T>(true, earlyFinishes);
+
+    EXPECT_EQ(ticked.ticks(), skipped.ticks());
+    EXPECT_EQ(ticked.programs_added(), skipped.programs_added());
+    EXPECT_EQ(ticked.programs_started(), skipped.programs_started());
+    EXPECT_EQ(ticked.programs_done(), skipped.programs_done());
+    EXPECT_DOUBLE_EQ(ticked.average_load(), skipped.average_load());
+    EXPECT_DOUBLE_EQ(ticked.wait_time().mean, skipped.wait_time().mean);
+    EXPECT_DOUBLE_EQ(ticked.wait_time().p99, skipped.wait_time().p99);
+    EXPECT_DOUBLE_EQ(ticked.bounded_slowdown().mean, skipped.bounded_slowdown().mean);
+}
+
+TEST(ClusterManagementSystemTest, run_until_matches_tick_by_tick)
+{
+    expect_event_driven_matches_ticks<basic_queue>();
+    expect_event_driven_matches_ticks<priority_queue<5>>();
+    expect_event_driven_matches_ticks<planning_queue<10>>();
+    expect_event_driven_matches_ticks<easy_backfill_queue<>>();
+    expect_event_driven_matches_ticks<conservative_backfill_queue<>>();
+    expect_event_driven_matches_ticks<conservative_backfill_queue<>>(true);
+}
+
+TEST(ClusterManagementSystemTest, can_advance_to_next_event)
+{
+    cluster_management_system<basic_queue> cms(4);
+    EXPECT_FALSE(cms.advance_to_next_event());
+
+    cms.add_program({ 2, 10 });
+    cms.add_program({ 4, 5 });
+
+    EXPECT_TRUE(cms.advance_to_next_event());
+    EXPECT_EQ(cms.current_tick(), 1);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 1);
+
+    EXPECT_TRUE(cms.advance_to_next_event());
+    EXPECT_EQ(cms.current_tick(), 11);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+
+    EXPECT_TRUE(cms.advance_to_next_event());
+    EXPECT_EQ(cms.current_tick(), 16);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 2);
+    EXPECT_FALSE(cms.advance_to_next_event());
+    EXPECT_DOUBLE_EQ(cms.get_statistics().average_load(), (2.0 * 10 + 4.0 * 5) / (4.0 * 16));
+}
+
+TEST(ClusterManagementSystemTest, finishes_programs_in_completion_order)
+{
+    cluster_management_system<basic_queue> cms(6);
+
+    cms.add_program({ 1, 5 });
+    cms.add_program({ 2, 1 });
+    cms.add_program({ 2, 3 });
+    cms.add_program({ 1, 3 });
+    cms.add_program({ 6, 1 });
+
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 4);
+
+    const uint64_t expectedDone[] = { 1, 1, 3, 3, 4, 5 };
+    for (uint64_t done : expectedDone)
+    {
+        cms.tick();
+        EXPECT_EQ(cms.get_statistics().programs_done(), done);
+    }
+    EXPECT_EQ(cms.get_statistics().programs_started(), 5);
+}
+
+template<typename T>
+static void expect_wide_program_not_starved()
+{
+    cluster_management_system<T> cms(4);
+
+    cms.add_program({ 2, 3 });
+    cms.add_program({ 4, 1 });
+    for (int i = 0; i < 20; ++i)
+    {
+        cms.add_program({ 2, 3 });
+    }
+
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+
+    cms.run_until(4);
+    auto stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_started(), 3);
+    EXPECT_EQ(stats.programs_done(), 2);
+
+    cms.tick();
+    stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_started(), 5);
+    EXPECT_EQ(stats.programs_done(), 3);
+}
+
+TEST(ClusterManagementSystemTest, backfill_queues_dont_starve_wide_programs)
+{
+    expect_wide_program_not_starved<easy_backfill_queue<>>();
+    expect_wide_program_not_starved<conservative_backfill_queue<>>();
+}
+
+template<typename T, typename U>
+static void expect_same_statistics()
+{
+    cluster_statistics first = run_random_workload<T>(true);
+    cluster_statistics second = run_random_workload<U>(true);
+
+    EXPECT_EQ(first.programs_started(), second.programs_started());
+    EXPECT_EQ(first.programs_done(), second.programs_done());
+    EXPECT_DOUBLE_EQ(first.average_load(), second.average_load());
+}
+
+TEST(ClusterManagementSystemTest, ring_buffer_storage_matches_linked_list)
+{
+    expect_same_statistics<basic_queue, fifo_queue<ring_buffer>>();
+    expect_same_statistics<priority_queue<5>, priority_queue<5, ring_buffer>>();
+    expect_same_statistics<planning_queue<10>, planning_queue<10, ring_buffer>>();
+    expect_same_statistics<easy_backfill_queue<>, easy_backfill_queue<UINT64_MAX, ring_buffer>>();
+    expect_same_statistics<conservative_backfill_queue<>, conservative_backfill_queue<UINT64_MAX, ring_buffer>>();
+}
+
+TEST(ClusterManagementSystemTest, cow_deque_storage_matches_linked_list)
+{
+    expect_same_statistics<basic_queue, fifo_queue<cow_deque>>();
+    expect_same_statistics<priority_queue<5>, priority_queue<5, cow_deque>>();
+    expect_same_statistics<planning_queue<10>, planning_queue<10, cow_deque>>();
+    expect_same_statistics<easy_backfill_queue<>, easy_backfill_queue<UINT64_MAX, cow_deque>>();
+    expect_same_statistics<conservative_backfill_queue<>, conservative_backfill_queue<UINT64_MAX, cow_deque>>();
+}
+
+TEST(ClusterManagementSystemTest, can_add_programs_in_batch)
+{
+    cluster_management_system<basic_queue> cms(4);
+    std::vector<program_info> programs = { { 2, 3 }, { 1, 2 }, { 4, 1 } };
+
+    cms.add_programs(programs);
+    EXPECT_EQ(cms.get_statistics().programs_added(), 3);
+
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+}
+
+TEST(ClusterManagementSystemTest, cant_add_batch_with_invalid_program)
+{
+    cluster_management_system<basic_queue> cms(4);
+    std::vector<program_info> programs = { { 2, 3 }, { 5, 2 } };
+
+    EXPECT_THROW(cms.add_programs(programs), std::invalid_argument);
+    EXPECT_EQ(cms.get_statistics().programs_added(), 0);
+
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 0);
+}
+
+class queue_without_batch
+{
+private:
+    basic_queue mQueue;
+public:
+    uint64_t pushed = 0;
+
+    std::optional<std::pair<uint64_t, program_info>> get(const cluster_state& state)
+    {
+        return mQueue.get(state);
+    }
+
+    uint64_t push(const program_info& program, uint64_t tick)
+    {
+        ++pushed;
+        return mQueue.push(program, tick);
+    }
+};
+
+TEST(ClusterManagementSystemTest, batch_falls_back_to_push)
+{
+    EXPECT_FALSE(has_push_batch<queue_without_batch>::value);
+    EXPECT_TRUE(has_push_batch<basic_queue>::value);
+
+    cluster_management_system<queue_without_batch> cms(4);
+    std::vector<program_info> programs = { { 2, 3 }, { 1, 2 } };
+    cms.add_programs(programs);
+    cms.tick();
+
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+}
+
+TEST(ClusterManagementSystemTest, tracks_program_latency)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 4, 10 });
+    cms.add_programs(std::vector<program_info>{ { 4, 5 } });
+    cms.run_until(20);
+
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_DOUBLE_EQ(stats.wait_time().mean, 6.0);
+    EXPECT_DOUBLE_EQ(stats.wait_time().p50, 1.0);
+    EXPECT_DOUBLE_EQ(stats.wait_time().max, 11.0);
+    EXPECT_DOUBLE_EQ(stats.turnaround_time().mean, 13.5);
+    EXPECT_DOUBLE_EQ(stats.turnaround_time().max, 16.0);
+    EXPECT_NEAR(stats.bounded_slowdown().p50, 1.1, 0.02);
+    EXPECT_DOUBLE_EQ(stats.bounded_slowdown().max, 1.6);
+}
+
+TEST(ClusterManagementSystemTest, records_load_timeline)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 3, 10 });
+    cms.add_program({ 2, 10 });
+    cms.run_until(30);
+
+    const load_timeline& timeline = cms.timeline();
+    EXPECT_EQ(timeline.ticks_recorded(), 30);
+
+    std::vector<timeline_bucket> ticks = timeline.buckets(0);
+    ASSERT_EQ(ticks.size(), 30);
+    EXPECT_EQ(ticks[0].loadMax, 3);
+    EXPECT_EQ(ticks[0].queueMax, 1);
+    EXPECT_EQ(ticks[10].loadMax, 2);
+    EXPECT_EQ(ticks[10].queueMax, 0);
+    EXPECT_EQ(ticks[25].loadMax, 0);
+}
+
+TEST(ClusterManagementSystemTest, submitted_programs_start_on_next_tick)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.submit_program({ 2, 5 });
+    EXPECT_EQ(cms.get_statistics().programs_added(), 0);
+
+    cms.tick();
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_added(), 1);
+    EXPECT_EQ(stats.programs_started(), 1);
+}
+
+TEST(ClusterManagementSystemTest, cant_submit_too_wide_program)
+{
+    cluster_management_system<basic_queue> cms(4);
+    ASSERT_ANY_THROW(cms.submit_program({ 5, 1 }));
+}
+
+TEST(ClusterManagementSystemTest, run_until_sees_pending_submissions)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.submit_program({ 4, 10 });
+    cms.run_until(100);
+
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_done(), 1);
+    EXPECT_EQ(stats.wait_time().max, 1.0);
+}
+
+TEST(ClusterManagementSystemTest, can_submit_from_many_threads)
+{
+    const int producers = 4;
+    const int perProducer = 2000;
+    cluster_management_system<easy_backfill_queue<100>> cms(16);
+
+    std::atomic<int> finished{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&cms, &finished, p]()
+        {
+            for (int i = 0; i < perProducer; ++i)
+            {
+                cms.submit_program({ (uint64_t)(1 + (p + i) % 16), (uint64_t)(i % 20) });
+            }
+            ++finished;
+        });
+    }
+
+    while (finished < producers)
+    {
+        cms.tick();
+    }
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    while (cms.advance_to_next_event()) {}
+
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_added(), producers * perProducer);
+    EXPECT_EQ(stats.programs_done(), producers * perProducer);
+}
+
+template<typename T>
+static void add_random_programs(cluster_management_system<T>& cms, std::default_random_engine& g, uint64_t untilTick)
+{
+    std::uniform_int_distribution<uint64_t> processorsDist(1, 16);
+    std::uniform_int_distribution<uint64_t> ticksDist(0, 60);
+    std::uniform_int_distribution<uint64_t> gapDist(0, 4);
+
+    for (uint64_t tick = cms.current_tick(); tick < untilTick; tick += gapDist(g))
+    {
+        cms.run_until(tick);
+        cms.add_program({ processorsDist(g), ticksDist(g) });
+    }
+    cms.run_until(untilTick);
+}
+
+TEST(ClusterManagementSystemTest, fork_continues_like_original)
+{
+    using queue = easy_backfill_queue<100, cow_deque>;
+    std::default_random_engine g(3);
+    cluster_management_system<queue> original(16);
+    add_random_programs(original, g, 2000);
+
+    cluster_management_system<queue> fork = original.fork();
+    std::default_random_engine forkRng = g;
+    add_random_programs(original, g, 4000);
+    add_random_programs(fork, forkRng, 4000);
+
+    cluster_statistics a = original.get_statistics();
+    cluster_statistics b = fork.get_statistics();
+    EXPECT_EQ(a.programs_added(), b.programs_added());
+    EXPECT_EQ(a.programs_started(), b.programs_started());
+    EXPECT_EQ(a.programs_done(), b.programs_done());
+    EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+    EXPECT_DOUBLE_EQ(a.wait_time().mean, b.wait_time().mean);
+}
+
+TEST(ClusterManagementSystemTest, forks_diverge_in_parallel)
+{
+    using queue = planning_queue<100, cow_deque>;
+    std::default_random_engine g(5);
+    cluster_management_system<queue> original(16);
+    add_random_programs(original, g, 1000);
+    const uint64_t added = original.get_statistics().programs_added();
+
+    std::vector<cluster_management_system<queue>> forks;
+    for (int i = 0; i < 4; ++i)
+    {
+        forks.push_back(original.fork());
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&forks, i]()
+        {
+            std::default_random_engine forkRng(100 + i);
+            add_random_programs(forks[i], forkRng, 3000);
+        });
+    }
+    add_random_programs(original, g, 3000);
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    for (auto& fork : forks)
+    {
+        while (fork.advance_to_next_event()) {}
+        cluster_statistics stats = fork.get_statistics();
+        EXPECT_GT(stats.programs_added(), added);
+        EXPECT_EQ(stats.programs_done(), stats.programs_added());
+    }
+    EXPECT_EQ(original.current_tick(), 3000);
+}
+
+TEST(ClusterManagementSystemTest, can_fork_with_other_policy)
+{
+    cluster_management_system<basic_queue> original(4);
+    original.add_program({ 4, 10 });
+    original.add_program({ 3, 10 });
+    original.add_program({ 1, 2 });
+    original.tick();
+
+    cluster_management_system<easy_backfill_queue<>> fork = original.fork_with_policy<easy_backfill_queue<>>();
+    original.run_until(5);
+    fork.run_until(5);
+
+    EXPECT_EQ(original.get_statistics().programs_started(), 1);
+    EXPECT_EQ(fork.get_statistics().programs_started(), 1);
+    EXPECT_EQ(fork.get_statistics().programs_added(), 3);
+
+    original.run_until(100);
+    fork.run_until(100);
+    EXPECT_EQ(original.get_statistics().programs_done(), 3);
+    EXPECT_EQ(fork.get_statistics().programs_done(), 3);
+    EXPECT_DOUBLE_EQ(fork.get_statistics().wait_time().max, 11.0);
+}
+
+TEST(ClusterManagementSystemTest, added_processors_start_waiting_programs)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 4, 100 });
+    cms.add_program({ 2, 10 });
+    cms.add_program({ 1, 10 });
+    cms.run_until(10);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 1);
+
+    EXPECT_ANY_THROW(cms.add_program({ 9, 1 }));
+    cms.add_processors(8);
+    EXPECT_EQ(cms.processors(), 12);
+    cms.run_until(11);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 3);
+    EXPECT_NO_THROW(cms.add_program({ 9, 1 }));
+    EXPECT_NO_THROW(cms.submit_program({ 12, 1 }));
+
+    cms.run_until(200);
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_EQ(stats.programs_done(), 5);
+    EXPECT_DOUBLE_EQ(stats.average_load(), (4.0 * 100 + 2 * 10 + 1 * 10 + 9 + 12) / (10 * 4 + 190 * 12));
+}
+
+TEST(ClusterManagementSystemTest, program_finishes_at_actual_time)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 2, 10, 3 });
+
+    cms.run_until(3);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 0);
+    cms.run_until(4);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 1);
+    EXPECT_EQ(cms.get_statistics().programs_killed(), 0);
+    EXPECT_EQ(cms.get_statistics().turnaround_time().max, 4);
+}
+
+TEST(ClusterManagementSystemTest, program_is_killed_at_limit)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 2, 5, 20 });
+    cms.add_program({ 2, 5 });
+
+    cms.run_until(5);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 0);
+    cms.run_until(6);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 2);
+    EXPECT_EQ(cms.get_statistics().programs_killed(), 1);
+}
+
+TEST(ClusterManagementSystemTest, backfill_plans_with_limit_and_releases_early)
+{
+    cluster_management_system<easy_backfill_queue<>> cms(4);
+    cms.add_program({ 3, 100, 10 });
+    cms.tick();
+    cms.add_program({ 4, 10 });
+    cms.add_program({ 1, 50 });
+
+    // The head's reservation is based on the 100-tick limit, so the 50-tick program fits before it.
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+
+    // The first program frees its processors at tick 11, but the head still has to wait for the backfilled one.
+    cms.run_until(51);
+    EXPECT_EQ(cms.get_statistics().programs_done(), 1);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+    cms.run_until(52);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 3);
+}
+
+TEST(ClusterManagementSystemTest, conservative_backfill_compresses_reservations_after_early_finish)
+{
+    cluster_management_system<conservative_backfill_queue<>> cms(4);
+    cms.add_program({ 4, 100, 10 });
+    cms.tick();
+    cms.add_program({ 4, 10 });
+    cms.add_program({ 2, 20 });
+    cms.tick();
+    EXPECT_EQ(cms.get_statistics().programs_started(), 1);
+
+    // Both reservations were made behind the 100-tick limit; the early finish at tick 11 pulls them in.
+    cms.run_until(11);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 2);
+    cms.run_until(21);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 3);
+    EXPECT_EQ(cms.get_statistics().wait_time().max, 20);
 }
\ No newline at end of file
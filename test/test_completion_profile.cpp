@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "completion_profile.h"
+
+TEST(CompletionProfileTest, empty_profile_never_frees_processors)
+{
+    completion_profile profile;
+    EXPECT_TRUE(profile.is_empty());
+    EXPECT_EQ(profile.ticks_wait(0, 2, 3), UINT64_MAX);
+}
+
+TEST(CompletionProfileTest, can_get_ticks_wait)
+{
+    completion_profile profile;
+    profile.add(15, 2);
+    profile.add(12, 1);
+    profile.add(15, 1);
+
+    EXPECT_EQ(profile.ticks_wait(10, 1, 2), 3);
+    EXPECT_EQ(profile.ticks_wait(10, 1, 5), 6);
+    EXPECT_EQ(profile.ticks_wait(10, 1, 6), UINT64_MAX);
+}
+
+TEST(CompletionProfileTest, can_remove_releases)
+{
+    completion_profile profile;
+    profile.add(12, 3);
+    profile.add(20, 1);
+
+    profile.remove(12, 2);
+    EXPECT_EQ(profile.ticks_wait(10, 0, 1), 3);
+    EXPECT_EQ(profile.ticks_wait(10, 0, 2), 11);
+
+    profile.remove(12, 1);
+    profile.remove(20, 1);
+    EXPECT_TRUE(profile.is_empty());
+    EXPECT_THROW(profile.remove(20, 1), std::out_of_range);
+}
\ No newline at end of file
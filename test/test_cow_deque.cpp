@@ -0,0 +1,171 @@
+#include "cow_deque.h"
+#include "cow_vector.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+template<typename T>
+static std::vector<T> to_vector(const cow_deque<T>& deque)
+{
+    std::vector<T> res;
+    for (const T& elem : deque)
+    {
+        res.push_back(elem);
+    }
+    return res;
+}
+
+TEST(CowDequeTest, can_push_back_and_pop_front)
+{
+    cow_deque<int> deque;
+    for (int i = 0; i < 1000; ++i)
+    {
+        deque.push_back(i);
+    }
+    EXPECT_EQ(deque.size(), 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(deque.front(), i);
+        deque.pop_front();
+    }
+    EXPECT_TRUE(deque.is_empty());
+}
+
+TEST(CowDequeTest, can_pop_back)
+{
+    cow_deque<int> deque = { 1, 2, 3 };
+    deque.pop_back();
+    EXPECT_EQ(deque.back(), 2);
+    EXPECT_EQ(deque.size(), 2);
+}
+
+TEST(CowDequeTest, can_erase_across_chunks)
+{
+    cow_deque<int> deque;
+    std::vector<int> expected;
+    for (int i = 0; i < 600; ++i)
+    {
+        deque.push_back(i);
+        expected.push_back(i);
+    }
+
+    for (int target : { 0, 255, 256, 300, 599 })
+    {
+        auto it = deque.begin();
+        while (*it != target)
+        {
+            ++it;
+        }
+        deque.erase(it);
+        expected.erase(std::find(expected.begin(), expected.end(), target));
+    }
+
+    EXPECT_EQ(to_vector(deque), expected);
+    EXPECT_EQ(deque.size(), expected.size());
+}
+
+TEST(CowDequeTest, copies_diverge_independently)
+{
+    cow_deque<int> original;
+    for (int i = 0; i < 700; ++i)
+    {
+        original.push_back(i);
+    }
+
+    cow_deque<int> copy = original;
+    copy.pop_front();
+    copy.push_back(700);
+    auto it = copy.begin();
+    ++it;
+    copy.erase(it);
+
+    original.pop_back();
+    original.push_back(-1);
+
+    std::vector<int> expectedOriginal;
+    for (int i = 0; i < 699; ++i)
+    {
+        expectedOriginal.push_back(i);
+    }
+    expectedOriginal.push_back(-1);
+
+    std::vector<int> expectedCopy;
+    expectedCopy.push_back(1);
+    for (int i = 3; i <= 700; ++i)
+    {
+        expectedCopy.push_back(i);
+    }
+
+    EXPECT_EQ(to_vector(original), expectedOriginal);
+    EXPECT_EQ(to_vector(copy), expectedCopy);
+}
+
+TEST(CowDequeTest, check_iterator_errors)
+{
+    cow_deque<int> deque;
+    ASSERT_ANY_THROW(*deque.end());
+    ASSERT_ANY_THROW(++deque.end());
+    ASSERT_ANY_THROW(deque.erase(deque.end()));
+    ASSERT_ANY_THROW(deque.pop_front());
+    ASSERT_ANY_THROW(deque.front());
+}
+
+TEST(CowVectorTest, copies_share_until_written)
+{
+    cow_vector<int> original(3000, 1);
+    cow_vector<int> copy = original;
+
+    copy[5] = 7;
+    original[2500] = 9;
+
+    EXPECT_EQ(original[5], 1);
+    EXPECT_EQ(copy[5], 7);
+    EXPECT_EQ(copy[2500], 1);
+    EXPECT_EQ(original[2500], 9);
+    EXPECT_EQ(copy.size(), 3000);
+}
+
+TEST(CowVectorTest, can_resize)
+{
+    cow_vector<int> values(10, 3);
+    values.resize(2000, 4);
+    EXPECT_EQ(values.size(), 2000);
+    EXPECT_EQ(values[9], 3);
+    EXPECT_EQ(values[10], 4);
+    EXPECT_EQ(values[1999], 4);
+
+    values.resize(5);
+    values.resize(6);
+    EXPECT_EQ(values[5], 0);
+}
+
+TEST(CowVectorTest, copies_can_be_written_from_different_threads)
+{
+    cow_vector<int> original(10000, 0);
+    std::vector<cow_vector<int>> copies(4, original);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&copies, t]()
+        {
+            for (size_t i = 0; i < copies[t].size(); ++i)
+            {
+                copies[t][i] = t;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < 4; ++t)
+    {
+        EXPECT_EQ(copies[t][9999], t);
+    }
+    EXPECT_EQ(original[9999], 0);
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "free_processor_index.h"
+
+TEST(FreeProcessorIndexTest, can_create)
+{
+    free_processor_index index(100);
+    EXPECT_EQ(index.size(), 100);
+    EXPECT_EQ(index.free_count(), 100);
+    EXPECT_TRUE(index.is_free(99));
+    EXPECT_THROW(index.is_free(100), std::out_of_range);
+}
+
+TEST(FreeProcessorIndexTest, acquires_lowest_free_processors)
+{
+    free_processor_index index(10);
+    std::vector<uint64_t> acquired;
+
+    index.acquire(3, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired, (std::vector<uint64_t>{ 0, 1, 2 }));
+    EXPECT_EQ(index.free_count(), 7);
+    EXPECT_FALSE(index.is_free(1));
+
+    index.release(1);
+    acquired.clear();
+    index.acquire(2, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired, (std::vector<uint64_t>{ 1, 3 }));
+}
+
+TEST(FreeProcessorIndexTest, works_across_words)
+{
+    free_processor_index index(200);
+    std::vector<uint64_t> acquired;
+
+    index.acquire(150, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired.size(), 150);
+    EXPECT_EQ(acquired.back(), 149);
+
+    index.release(3);
+    index.release(130);
+    acquired.clear();
+    index.acquire(52, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired.front(), 3);
+    EXPECT_EQ(acquired[1], 130);
+    EXPECT_EQ(acquired.back(), 199);
+    EXPECT_EQ(index.free_count(), 0);
+}
+
+TEST(FreeProcessorIndexTest, cant_acquire_more_than_free)
+{
+    free_processor_index index(4);
+    EXPECT_THROW(index.acquire(5, [](uint64_t) {}), std::out_of_range);
+}
+
+TEST(FreeProcessorIndexTest, cant_release_free_processor)
+{
+    free_processor_index index(4);
+    EXPECT_THROW(index.release(2), std::logic_error);
+}
+
+TEST(FreeProcessorIndexTest, can_grow)
+{
+    free_processor_index index(70);
+    std::vector<uint64_t> acquired;
+    index.acquire(70, [&](uint64_t i) { acquired.push_back(i); });
+
+    index.grow(100);
+    EXPECT_EQ(index.size(), 170);
+    EXPECT_EQ(index.free_count(), 100);
+    EXPECT_FALSE(index.is_free(69));
+    EXPECT_TRUE(index.is_free(70));
+    EXPECT_TRUE(index.is_free(169));
+
+    acquired.clear();
+    index.acquire(100, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired.front(), 70);
+    EXPECT_EQ(acquired.back(), 169);
+}
+
+TEST(FreeProcessorIndexTest, acquires_within_range)
+{
+    free_processor_index index(200);
+    std::vector<uint64_t> acquired;
+
+    index.acquire_range(60, 130, 10, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired, (std::vector<uint64_t>{ 60, 61, 62, 63, 64, 65, 66, 67, 68, 69 }));
+    EXPECT_EQ(index.free_count(), 190);
+
+    acquired.clear();
+    index.acquire_range(60, 72, 2, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired, (std::vector<uint64_t>{ 70, 71 }));
+    EXPECT_THROW(index.acquire_range(60, 72, 1, [](uint64_t) {}), std::out_of_range);
+    EXPECT_THROW(index.acquire_range(10, 201, 1, [](uint64_t) {}), std::out_of_range);
+
+    acquired.clear();
+    index.acquire(3, [&](uint64_t i) { acquired.push_back(i); });
+    EXPECT_EQ(acquired, (std::vector<uint64_t>{ 0, 1, 2 }));
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include "indexed_heap.h"
+
+TEST(IndexedHeapTest, pops_in_key_order)
+{
+    indexed_heap<int> heap;
+    heap.push(0, 5);
+    heap.push(3, 1);
+    heap.push(1, 4);
+    heap.push(7, 2);
+
+    EXPECT_EQ(heap.size(), 4);
+    EXPECT_EQ(heap.top(), 3);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 7);
+    EXPECT_EQ(heap.top_key(), 2);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 1);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 0);
+    heap.pop();
+    EXPECT_TRUE(heap.is_empty());
+    EXPECT_THROW(heap.pop(), std::out_of_range);
+}
+
+TEST(IndexedHeapTest, can_update_and_erase)
+{
+    indexed_heap<int> heap;
+    heap.push(0, 5);
+    heap.push(1, 4);
+    heap.push(2, 3);
+
+    heap.update(0, 1);
+    EXPECT_EQ(heap.top(), 0);
+    heap.update(0, 10);
+    EXPECT_EQ(heap.top(), 2);
+    EXPECT_EQ(heap.key(0), 10);
+
+    heap.erase(2);
+    EXPECT_FALSE(heap.contains(2));
+    EXPECT_EQ(heap.top(), 1);
+    EXPECT_THROW(heap.erase(2), std::out_of_range);
+    EXPECT_THROW(heap.push(1, 0), std::logic_error);
+}
+
+TEST(IndexedHeapTest, rebuilds_same_heap_in_array_order)
+{
+    indexed_heap<int> heap;
+    for (uint32_t handle = 0; handle < 20; ++handle)
+    {
+        heap.push(handle, (int)((handle * 7) % 20));
+    }
+    heap.pop();
+    heap.update(5, -1);
+
+    indexed_heap<int> copy;
+    heap.for_each([&](uint32_t handle, int key) { copy.push(handle, key); });
+
+    std::vector<std::pair<uint32_t, int>> a;
+    std::vector<std::pair<uint32_t, int>> b;
+    heap.for_each([&](uint32_t handle, int key) { a.push_back({ handle, key }); });
+    copy.for_each([&](uint32_t handle, int key) { b.push_back({ handle, key }); });
+    EXPECT_EQ(a, b);
+}
+
+TEST(IndexedHeapTest, matches_ordered_set)
+{
+    std::default_random_engine g(11);
+    std::uniform_int_distribution<uint32_t> handleDist(0, 200);
+    std::uniform_int_distribution<int> keyDist(0, 1000);
+    std::uniform_int_distribution<int> actionDist(0, 3);
+
+    indexed_heap<std::pair<int, uint32_t>> heap;
+    std::set<std::pair<int, uint32_t>> reference;
+    std::map<uint32_t, int> keys;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const uint32_t handle = handleDist(g);
+        const int key = keyDist(g);
+        switch (actionDist(g))
+        {
+        case 0:
+            if (!heap.contains(handle))
+            {
+                heap.push(handle, { key, handle });
+                reference.insert({ key, handle });
+                keys[handle] = key;
+            }
+            break;
+        case 1:
+            if (heap.contains(handle))
+            {
+                heap.update(handle, { key, handle });
+                reference.erase({ keys[handle], handle });
+                reference.insert({ key, handle });
+                keys[handle] = key;
+            }
+            break;
+        case 2:
+            if (heap.contains(handle))
+            {
+                heap.erase(handle);
+                reference.erase({ keys[handle], handle });
+                keys.erase(handle);
+            }
+            break;
+        default:
+            if (!reference.empty())
+            {
+                ASSERT_EQ(heap.top(), reference.begin()->second);
+                keys.erase(heap.top());
+                reference.erase(reference.begin());
+                heap.pop();
+            }
+        }
+        ASSERT_EQ(heap.size(), reference.size());
+    }
+}
\ No newline at end of file
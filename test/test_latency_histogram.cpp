@@ -0,0 +1,85 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogramTest, empty_histogram_reports_zero)
+{
+    latency_histogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.value_at_quantile(0.5), 0);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, small_values_are_exact)
+{
+    latency_histogram histogram;
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        histogram.record(i);
+    }
+
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.value_at_quantile(0.0), 1);
+    EXPECT_EQ(histogram.value_at_quantile(0.5), 50);
+    EXPECT_EQ(histogram.value_at_quantile(0.99), 99);
+    EXPECT_EQ(histogram.value_at_quantile(1.0), 100);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+}
+
+TEST(LatencyHistogramTest, large_values_stay_within_relative_error)
+{
+    std::default_random_engine g(7);
+    std::lognormal_distribution<double> dist(8.0, 3.0);
+
+    latency_histogram histogram;
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t value = (uint64_t)dist(g);
+        values.push_back(value);
+        histogram.record(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double q : { 0.1, 0.5, 0.9, 0.99, 0.999 })
+    {
+        uint64_t exact = values[(size_t)std::ceil(q * values.size()) - 1];
+        uint64_t approximate = histogram.value_at_quantile(q);
+        EXPECT_GE(approximate, exact);
+        EXPECT_LE(approximate - exact, exact / 64 + 1);
+    }
+    EXPECT_EQ(histogram.value_at_quantile(1.0), values.back());
+    EXPECT_EQ(histogram.max(), values.back());
+}
+
+TEST(LatencyHistogramTest, handles_full_value_range)
+{
+    latency_histogram histogram;
+    histogram.record(UINT64_MAX);
+    histogram.record(0);
+
+    EXPECT_EQ(histogram.value_at_quantile(0.5), 0);
+    EXPECT_EQ(histogram.value_at_quantile(1.0), UINT64_MAX);
+}
+
+TEST(LatencyHistogramTest, throws_on_invalid_quantile)
+{
+    latency_histogram histogram;
+    ASSERT_ANY_THROW(histogram.value_at_quantile(1.5));
+    ASSERT_ANY_THROW(histogram.value_at_quantile(-0.1));
+}
+
+TEST(LatencyHistogramTest, summary_applies_scale)
+{
+    latency_histogram histogram;
+    histogram.record(1500);
+    histogram.record(2500);
+
+    latency_summary summary = histogram.summary(1000);
+    EXPECT_DOUBLE_EQ(summary.mean, 2.0);
+    EXPECT_DOUBLE_EQ(summary.max, 2.5);
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "linked_list.h"
 #include <exception>
+#include <string>
 #include <gtest/gtest.h>
 
 TEST(LinkedListTest, can_create_with_default_constructor)
@@ -266,3 +267,84 @@ TEST(LinkedListTest, can_clear_list)
     EXPECT_THROW(list.front(), std::out_of_range);
     EXPECT_THROW(list.back(), std::out_of_range);
 }
+
+
+TEST(LinkedListTest, reuses_nodes_after_pop)
+{
+    linked_list<int> list = { 1 };
+    const int* first = &list.front();
+
+    list.pop_front();
+    list.push_back(2);
+    EXPECT_EQ(&list.front(), first);
+}
+
+TEST(LinkedListTest, keeps_nodes_after_move)
+{
+    linked_list<std::string> list;
+    for (int i = 0; i < 100; ++i)
+    {
+        list.push_back(std::to_string(i));
+    }
+
+    linked_list<std::string> moved;
+    moved.push_back("old");
+    moved = std::move(list);
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_EQ(moved.back(), "99");
+
+    list.push_back("new");
+    EXPECT_EQ(list.size(), 1);
+    EXPECT_EQ(list.front(), "new");
+}
+
+TEST(LinkedListTest, can_iterate_backward_after_push_front)
+{
+    linked_list<int> list;
+    list.push_front(2);
+    list.push_front(1);
+
+    auto it = --list.end();
+    EXPECT_EQ(*it, 2);
+    --it;
+    EXPECT_EQ(*it, 1);
+}
+
+TEST(LinkedListTest, can_insert_at_beginning)
+{
+    linked_list<int> list = { 2, 3 };
+    list.insert(list.begin(), 1);
+
+    EXPECT_EQ(list.size(), 3);
+    EXPECT_EQ(list.front(), 1);
+    EXPECT_EQ(*(++list.begin()), 2);
+}
+
+TEST(LinkedListTest, can_reserve_nodes)
+{
+    linked_list<int> list = { 1 };
+    list.reserve(100);
+    for (int i = 2; i <= 100; ++i)
+    {
+        list.push_back(i);
+    }
+
+    EXPECT_EQ(list.size(), 100);
+    EXPECT_EQ(list.back(), 100);
+}
+
+TEST(LinkedListTest, small_reserves_share_growing_slabs)
+{
+    linked_list<int> list;
+    for (int batch = 0; batch < 1000; ++batch)
+    {
+        list.reserve(list.size() + 3);
+        for (int i = 0; i < 3; ++i)
+        {
+            list.push_back(batch);
+        }
+    }
+
+    EXPECT_EQ(list.size(), 3000);
+    EXPECT_LE(list.slab_count(), 10);
+}
\ No newline at end of file
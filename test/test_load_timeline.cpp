@@ -0,0 +1,133 @@
+#include "load_timeline.h"
+#include <exception>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+static void expect_bucket_eq(const timeline_bucket& a, const timeline_bucket& b)
+{
+    EXPECT_EQ(a.tickStart, b.tickStart);
+    EXPECT_EQ(a.ticks, b.ticks);
+    EXPECT_EQ(a.loadMin, b.loadMin);
+    EXPECT_EQ(a.loadMax, b.loadMax);
+    EXPECT_DOUBLE_EQ(a.loadSum, b.loadSum);
+    EXPECT_EQ(a.queueMin, b.queueMin);
+    EXPECT_EQ(a.queueMax, b.queueMax);
+    EXPECT_DOUBLE_EQ(a.queueSum, b.queueSum);
+}
+
+TEST(LoadTimelineTest, cant_create_with_invalid_parameters)
+{
+    ASSERT_ANY_THROW(load_timeline(1));
+    ASSERT_ANY_THROW(load_timeline(16, 2, 1));
+}
+
+TEST(LoadTimelineTest, aggregates_samples_per_bucket)
+{
+    load_timeline timeline(8, 2, 4);
+    for (uint64_t i = 0; i < 6; ++i)
+    {
+        timeline.record(i, 10 - i);
+    }
+
+    std::vector<timeline_bucket> fine = timeline.buckets(0);
+    ASSERT_EQ(fine.size(), 6);
+    EXPECT_EQ(fine[2].tickStart, 3);
+    EXPECT_EQ(fine[2].loadMax, 2);
+
+    std::vector<timeline_bucket> coarse = timeline.buckets(1);
+    ASSERT_EQ(coarse.size(), 2);
+    EXPECT_EQ(coarse[0].tickStart, 1);
+    EXPECT_EQ(coarse[0].ticks, 4);
+    EXPECT_EQ(coarse[0].loadMin, 0);
+    EXPECT_EQ(coarse[0].loadMax, 3);
+    EXPECT_DOUBLE_EQ(coarse[0].load_mean(), 1.5);
+    EXPECT_EQ(coarse[0].queueMin, 7);
+    EXPECT_EQ(coarse[0].queueMax, 10);
+    EXPECT_EQ(coarse[1].tickStart, 5);
+    EXPECT_EQ(coarse[1].ticks, 2);
+}
+
+TEST(LoadTimelineTest, keeps_only_newest_buckets_per_level)
+{
+    load_timeline timeline(8, 1, 4);
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        timeline.record(i, 0);
+    }
+
+    std::vector<timeline_bucket> fine = timeline.buckets(0);
+    ASSERT_EQ(fine.size(), 8);
+    EXPECT_EQ(fine.front().tickStart, 93);
+    EXPECT_EQ(fine.back().tickStart, 100);
+    EXPECT_EQ(fine.back().loadMax, 100);
+}
+
+TEST(LoadTimelineTest, overview_covers_whole_run)
+{
+    load_timeline timeline(16, 2, 4);
+    for (uint64_t i = 0; i < 100000; ++i)
+    {
+        timeline.record(i % 7, 1);
+    }
+
+    std::vector<timeline_bucket> overview = timeline.buckets(timeline.overview_level());
+    EXPECT_LE(overview.size(), 16);
+    EXPECT_EQ(overview.front().tickStart, 1);
+
+    uint64_t ticks = 0;
+    for (const timeline_bucket& bucket : overview)
+    {
+        EXPECT_EQ(bucket.tickStart, ticks + 1);
+        ticks += bucket.ticks;
+    }
+    EXPECT_EQ(ticks, 100000);
+    EXPECT_EQ(timeline.ticks_recorded(), 100000);
+}
+
+TEST(LoadTimelineTest, batch_record_matches_single_ticks)
+{
+    load_timeline single(16, 3, 4);
+    load_timeline batch(16, 3, 4);
+    const uint64_t runs[][3] = { { 3, 1, 5 }, { 7, 2, 1 }, { 0, 0, 1000 }, { 5, 4, 37 }, { 2, 9, 3 } };
+    for (const auto& run : runs)
+    {
+        for (uint64_t i = 0; i < run[2]; ++i)
+        {
+            single.record(run[0], run[1]);
+        }
+        batch.record(run[0], run[1], run[2]);
+    }
+
+    for (size_t level = 0; level < single.level_count(); ++level)
+    {
+        std::vector<timeline_bucket> a = single.buckets(level);
+        std::vector<timeline_bucket> b = batch.buckets(level);
+        ASSERT_EQ(a.size(), b.size());
+        EXPECT_EQ(single.bucket_width(level), batch.bucket_width(level));
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            expect_bucket_eq(a[i], b[i]);
+        }
+    }
+}
+
+TEST(LoadTimelineTest, can_write_csv)
+{
+    load_timeline timeline(8, 1, 2);
+    timeline.record(4, 2, 2);
+
+    std::ostringstream out;
+    timeline.write_csv(out, 0);
+    EXPECT_EQ(out.str(),
+        "tick_start,ticks,load_min,load_mean,load_max,queue_min,queue_mean,queue_max\n"
+        "1,1,4,4,4,2,2,2\n"
+        "2,1,4,4,4,2,2,2\n");
+}
+
+TEST(LoadTimelineTest, throws_on_invalid_level)
+{
+    load_timeline timeline(8, 2, 2);
+    ASSERT_ANY_THROW(timeline.buckets(3));
+    ASSERT_ANY_THROW(timeline.bucket_width(3));
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "mpsc_queue.h"
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+TEST(MpscQueueTest, new_queue_is_empty)
+{
+    mpsc_queue<int> queue;
+    int value;
+    EXPECT_TRUE(queue.is_empty());
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(MpscQueueTest, pops_in_push_order)
+{
+    mpsc_queue<int> queue;
+    for (int i = 0; i < 100; ++i)
+    {
+        queue.push(i);
+    }
+
+    int value;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.is_empty());
+}
+
+TEST(MpscQueueTest, can_destroy_non_empty_queue)
+{
+    mpsc_queue<std::vector<int>> queue;
+    queue.push({ 1, 2, 3 });
+    queue.push({ 4 });
+}
+
+TEST(MpscQueueTest, delivers_all_values_from_many_producers)
+{
+    const int producers = 4;
+    const int perProducer = 20000;
+    mpsc_queue<std::pair<int, int>> queue;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < perProducer; ++i)
+            {
+                queue.push({ p, i });
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    std::pair<int, int> value;
+    while (received < producers * perProducer)
+    {
+        if (queue.try_pop(value))
+        {
+            EXPECT_EQ(value.second, next[value.first]);
+            next[value.first] = value.second + 1;
+            ++received;
+        }
+    }
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    EXPECT_TRUE(queue.is_empty());
+}
\ No newline at end of file
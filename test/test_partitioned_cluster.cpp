@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "partitioned_cluster.h"
+#include "cluster_management_system.h"
+#include "basic_queue.h"
+
+namespace
+{
+    std::vector<partition_config> batch_and_debug(bool debugLends)
+    {
+        return {
+            { "batch", "basic", 4, false, true },
+            { "debug", "easy:lookahead=100", 8, debugLends, false },
+        };
+    }
+
+    void fill(partitioned_cluster& cluster, uint64_t seed)
+    {
+        std::default_random_engine g((unsigned)seed);
+        std::uniform_int_distribution<uint64_t> ticksDist(1, 40);
+        for (uint64_t tick = 0; tick < 400; tick += 5)
+        {
+            cluster.run_until(tick);
+            for (size_t i = 0; i < cluster.partition_count(); ++i)
+            {
+                std::uniform_int_distribution<uint64_t> processorsDist(1, cluster.config(i).processors);
+                cluster.add_program(i, { processorsDist(g), ticksDist(g) });
+            }
+        }
+        cluster.run_until(5000);
+    }
+}
+
+TEST(PartitionedClusterTest, migrated_program_runs_on_other_system)
+{
+    cluster_management_system<basic_queue> busy(4);
+    cluster_management_system<basic_queue> idle(8);
+    busy.add_program({ 4, 10 });
+    busy.add_program({ 4, 10 });
+    busy.tick();
+    idle.tick();
+    EXPECT_EQ(busy.waiting_programs(), 1);
+
+    auto program = busy.migrate_program(idle.state());
+    ASSERT_TRUE(program.has_value());
+    idle.adopt_program(program.value().first, program.value().second);
+    EXPECT_EQ(busy.waiting_programs(), 0);
+    EXPECT_EQ(busy.programs_migrated(), 1);
+    EXPECT_EQ(idle.free_processors(), 4);
+    EXPECT_THROW(idle.adopt_program(7, { 5, 10 }), std::invalid_argument);
+
+    busy.run_until(20);
+    idle.run_until(20);
+    EXPECT_EQ(busy.get_statistics().programs_done(), 1);
+    EXPECT_EQ(idle.get_statistics().programs_done(), 1);
+    EXPECT_EQ(idle.get_statistics().programs_started(), 1);
+}
+
+TEST(PartitionedClusterTest, borrows_idle_processors_of_lending_partition)
+{
+    partitioned_cluster cluster(batch_and_debug(true));
+    const size_t batch = cluster.partition_index("batch");
+    const size_t debug = cluster.partition_index("debug");
+    cluster.add_program(batch, { 4, 10 });
+    cluster.add_program(batch, { 4, 10 });
+    cluster.add_program(batch, { 4, 10 });
+    cluster.tick();
+
+    EXPECT_EQ(cluster.usage(batch).programsBorrowed, 2);
+    EXPECT_EQ(cluster.usage(batch).processorTicksBorrowed, 80);
+    EXPECT_EQ(cluster.usage(debug).programsLent, 2);
+    EXPECT_EQ(cluster.usage(debug).processorTicksLent, 80);
+
+    cluster.run_until(12);
+    cluster_statistics stats = cluster.get_statistics();
+    EXPECT_EQ(stats.programs_added(), 3);
+    EXPECT_EQ(stats.programs_started(), 3);
+    EXPECT_EQ(stats.programs_done(), 3);
+    EXPECT_EQ(cluster.get_statistics(batch).programs_added(), 1);
+    EXPECT_EQ(cluster.get_statistics(debug).programs_added(), 2);
+    EXPECT_EQ(cluster.get_statistics(debug).programs_done(), 2);
+}
+
+TEST(PartitionedClusterTest, lender_timeline_matches_its_load)
+{
+    partitioned_cluster cluster(batch_and_debug(true));
+    cluster.add_program(0, { 4, 10 });
+    cluster.add_program(0, { 4, 10 });
+    cluster.run_until(20);
+
+    double loadSum = 0;
+    for (const timeline_bucket& bucket : cluster.timeline(1).buckets(0))
+    {
+        loadSum += bucket.loadSum;
+    }
+    EXPECT_DOUBLE_EQ(loadSum, 4.0 * 10);
+    EXPECT_DOUBLE_EQ(cluster.get_statistics(1).average_load() * 8 * 20, loadSum);
+}
+
+TEST(PartitionedClusterTest, skipping_ticks_matches_tick_stepping_after_migration)
+{
+    const std::vector<partition_config> partitions{
+        { "batch", "basic", 8, false, true },
+        { "debug", "basic", 8, true, false },
+    };
+
+    partitioned_cluster stepped(partitions, default_scheduler_registry(), 1, 10);
+    partitioned_cluster skipped(partitions, default_scheduler_registry(), 1, 10);
+    for (partitioned_cluster* cluster : { &stepped, &skipped })
+    {
+        cluster->add_program(0, { 4, 100 });
+        cluster->tick();
+        cluster->add_program(0, { 8, 5 });
+        cluster->add_program(0, { 2, 5 });
+    }
+
+    while (stepped.current_tick() < 40)
+    {
+        stepped.tick();
+    }
+    skipped.run_until(40);
+
+    cluster_statistics a = stepped.get_statistics(0);
+    cluster_statistics b = skipped.get_statistics(0);
+    EXPECT_EQ(stepped.usage(0).programsBorrowed, 1);
+    EXPECT_EQ(a.programs_done(), 1);
+    EXPECT_EQ(a.programs_done(), b.programs_done());
+    EXPECT_DOUBLE_EQ(a.wait_time().max, b.wait_time().max);
+    EXPECT_DOUBLE_EQ(a.wait_time().mean, b.wait_time().mean);
+}
+
+TEST(PartitionedClusterTest, keeps_programs_in_their_partition_without_lenders)
+{
+    partitioned_cluster noLender(batch_and_debug(false));
+    partitioned_cluster disabled(batch_and_debug(true), default_scheduler_registry(), 1, 1, false);
+    for (partitioned_cluster* cluster : { &noLender, &disabled })
+    {
+        cluster->add_program(0, { 4, 10 });
+        cluster->add_program(0, { 4, 10 });
+        cluster->run_until(12);
+        EXPECT_EQ(cluster->get_statistics().programs_done(), 1);
+        EXPECT_EQ(cluster->usage(0).programsBorrowed, 0);
+        EXPECT_EQ(cluster->usage(1).programsLent, 0);
+
+        cluster->run_until(22);
+        EXPECT_EQ(cluster->get_statistics().programs_done(), 2);
+    }
+}
+
+TEST(PartitionedClusterTest, busy_partition_does_not_lend)
+{
+    partitioned_cluster cluster(batch_and_debug(true));
+    cluster.add_program(1, { 6, 10 });
+    cluster.add_program(1, { 6, 10 });
+    cluster.add_program(0, { 4, 10 });
+    cluster.add_program(0, { 2, 10 });
+    cluster.tick();
+
+    EXPECT_EQ(cluster.usage(0).programsBorrowed, 0);
+    EXPECT_EQ(cluster.get_statistics(1).programs_started(), 1);
+}
+
+TEST(PartitionedClusterTest, results_do_not_depend_on_thread_count)
+{
+    const std::vector<partition_config> partitions{
+        { "debug", "basic", 8, true, false },
+        { "batch", "conservative:lookahead=100", 32, true, true },
+        { "wide", "sjf:aging=1", 64, false, true },
+    };
+
+    partitioned_cluster serial(partitions, default_scheduler_registry(), 1, 3);
+    partitioned_cluster parallel(partitions, default_scheduler_registry(), 4, 3);
+    fill(serial, 11);
+    fill(parallel, 11);
+
+    cluster_statistics a = serial.get_statistics();
+    cluster_statistics b = parallel.get_statistics();
+    EXPECT_EQ(a.programs_added(), 240);
+    EXPECT_EQ(a.programs_done(), 240);
+    EXPECT_EQ(a.programs_done(), b.programs_done());
+    EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+    EXPECT_DOUBLE_EQ(a.wait_time().mean, b.wait_time().mean);
+    for (size_t i = 0; i < partitions.size(); ++i)
+    {
+        EXPECT_EQ(serial.usage(i).processorTicksLent, parallel.usage(i).processorTicksLent);
+        EXPECT_EQ(serial.usage(i).processorTicksBorrowed, parallel.usage(i).processorTicksBorrowed);
+    }
+}
+
+TEST(PartitionedClusterTest, rejects_invalid_partitions)
+{
+    EXPECT_THROW(partitioned_cluster(std::vector<partition_config>()), std::invalid_argument);
+    EXPECT_THROW(partitioned_cluster({ { "a", "basic", 4, true, true }, { "a", "basic", 4, true, true } }), std::invalid_argument);
+    EXPECT_THROW(partitioned_cluster({ { "a", "unknown", 4, true, true } }), std::invalid_argument);
+    EXPECT_THROW(partitioned_cluster(batch_and_debug(true), default_scheduler_registry(), 1, 0), std::invalid_argument);
+
+    partitioned_cluster cluster(batch_and_debug(true));
+    EXPECT_THROW(cluster.partition_index("wide"), std::invalid_argument);
+    EXPECT_THROW(cluster.add_program(0, { 5, 10 }), std::invalid_argument);
+    EXPECT_THROW(cluster.add_program(2, { 1, 10 }), std::out_of_range);
+}
\ No newline at end of file
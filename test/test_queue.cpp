@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
 #include "basic_queue.h"
 #include "planning_queue.h"
 #include "priority_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
+#include "heap_queue.h"
+#include "fair_share_queue.h"
+#include "cluster_management_system.h"
 #include "cluster_state.h"
 #include "program_info.h"
 
@@ -227,4 +235,411 @@ TEST(PriorityQueueTest, cant_get_after_delay_has_expired)
     state.currentTick++;
     result = queue.get(state);
     EXPECT_FALSE(result.has_value());
+}
+
+TEST(PlanningQueueTest, backfills_only_programs_that_finish_before_head_can_start)
+{
+    planning_queue<> queue;
+    cluster_state state{ 2, 10, std::vector<processor_state>(4) };
+    state.completions.add(14, 2);
+
+    queue.push({ 4, 5 }, 10);
+    queue.push({ 1, 6 }, 10);
+    queue.push({ 2, 5 }, 10);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 2);
+
+    state.freeProcessors -= 2;
+    result = queue.get(state);
+    EXPECT_FALSE(result.has_value());
+}
+
+
+TEST(EasyBackfillQueueTest, can_push_and_get)
+{
+    easy_backfill_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+
+    uint64_t id = queue.push({ 2, 5 }, 0);
+    EXPECT_EQ(id, 0);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 0);
+    EXPECT_EQ(result->second.processors, 2);
+}
+
+TEST(EasyBackfillQueueTest, cant_get_from_empty_queue)
+{
+    easy_backfill_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    EXPECT_FALSE(queue.get(state).has_value());
+}
+
+TEST(EasyBackfillQueueTest, backfills_programs_that_finish_before_reservation)
+{
+    easy_backfill_queue<> queue;
+    cluster_state state{ 1, 10, std::vector<processor_state>(4) };
+    state.completions.add(14, 3);
+
+    queue.push({ 4, 5 }, 10);
+    queue.push({ 1, 10 }, 10);
+    queue.push({ 1, 4 }, 10);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 2);
+}
+
+TEST(EasyBackfillQueueTest, backfills_long_programs_on_extra_processors)
+{
+    easy_backfill_queue<> queue;
+    cluster_state state{ 2, 10, std::vector<processor_state>(5) };
+    state.completions.add(14, 3);
+
+    queue.push({ 3, 5 }, 10);
+    queue.push({ 1, 100 }, 10);
+    queue.push({ 1, 100 }, 10);
+    queue.push({ 1, 100 }, 10);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 1);
+
+    state.freeProcessors -= 1;
+    state.completions.add(110, 1);
+    result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 2);
+
+    state.freeProcessors -= 1;
+    state.completions.add(110, 1);
+    result = queue.get(state);
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(EasyBackfillQueueTest, cant_get_after_lookahead)
+{
+    easy_backfill_queue<1> queue;
+    cluster_state state{ 1, 10, std::vector<processor_state>(4) };
+    state.completions.add(14, 3);
+
+    queue.push({ 4, 5 }, 10);
+    queue.push({ 1, 10 }, 10);
+    queue.push({ 1, 4 }, 10);
+
+    EXPECT_FALSE(queue.get(state).has_value());
+}
+
+TEST(ConservativeBackfillQueueTest, can_push_and_get)
+{
+    conservative_backfill_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+
+    uint64_t id = queue.push({ 2, 5 }, 0);
+    EXPECT_EQ(id, 0);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 0);
+}
+
+TEST(ConservativeBackfillQueueTest, cant_get_from_empty_queue)
+{
+    conservative_backfill_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    EXPECT_FALSE(queue.get(state).has_value());
+}
+
+TEST(ConservativeBackfillQueueTest, backfills_programs_that_dont_delay_reservations)
+{
+    conservative_backfill_queue<> queue;
+    cluster_state state{ 2, 10, std::vector<processor_state>(4) };
+    state.completions.add(14, 2);
+
+    queue.push({ 4, 5 }, 10);
+    queue.push({ 2, 10 }, 10);
+    queue.push({ 2, 4 }, 10);
+
+    auto result = queue.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 2);
+}
+
+TEST(ConservativeBackfillQueueTest, keeps_reservations_for_all_queued_programs)
+{
+    easy_backfill_queue<> easy;
+    conservative_backfill_queue<> conservative;
+    cluster_state state{ 2, 10, std::vector<processor_state>(4) };
+    state.completions.add(12, 2);
+
+    for (program_info program : { program_info{ 3, 2 }, program_info{ 4, 2 }, program_info{ 1, 10 } })
+    {
+        easy.push(program, 10);
+        conservative.push(program, 10);
+    }
+
+    auto result = easy.get(state);
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(result->first, 2);
+
+    EXPECT_FALSE(conservative.get(state).has_value());
+}
+
+TEST(PriorityQueueTest, selects_same_programs_as_linear_scan)
+{
+    struct reference_record
+    {
+        uint64_t id;
+        uint64_t tickAdded;
+        program_info info;
+    };
+
+    std::default_random_engine g(7);
+    std::uniform_int_distribution<uint64_t> widthDist(1, 16);
+    std::uniform_int_distribution<uint64_t> freeDist(0, 16);
+    std::uniform_int_distribution<int> actionDist(0, 2);
+
+    priority_queue<3> queue;
+    std::vector<reference_record> reference;
+    cluster_state state{ 0, 0, std::vector<processor_state>(16) };
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        if (actionDist(g) == 0)
+        {
+            ++state.currentTick;
+        }
+
+        if (actionDist(g) != 0)
+        {
+            program_info info{ widthDist(g), 1 };
+            uint64_t id = queue.push(info, state.currentTick);
+            reference.push_back({ id, state.currentTick, info });
+            continue;
+        }
+
+        state.freeProcessors = freeDist(g);
+        std::optional<uint64_t> expected;
+        for (auto it = reference.begin(); it != reference.end(); ++it)
+        {
+            if (it->info.processors <= state.freeProcessors)
+            {
+                expected = it->id;
+                reference.erase(it);
+                break;
+            } else if (state.currentTick - it->tickAdded > 3)
+            {
+                break;
+            }
+        }
+
+        auto result = queue.get(state);
+        ASSERT_EQ(result.has_value(), expected.has_value());
+        if (expected.has_value())
+        {
+            EXPECT_EQ(result->first, *expected);
+        }
+    }
+}
+
+TEST(BasicQueueTest, can_push_batch)
+{
+    basic_queue queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    queue.push({ 1, 1 }, 0);
+
+    program_info programs[] = { { 2, 5 }, { 3, 5 } };
+    EXPECT_EQ(queue.push_batch(programs, 2, 0), 1);
+    EXPECT_EQ(queue.push({ 1, 1 }, 0), 3);
+
+    EXPECT_EQ(queue.get(state)->first, 0);
+    EXPECT_EQ(queue.get(state)->first, 1);
+}
+
+TEST(PriorityQueueTest, can_push_batch)
+{
+    priority_queue<5> queue;
+    cluster_state state{ 2, 0, std::vector<processor_state>(4) };
+
+    program_info programs[] = { { 4, 5 }, { 2, 5 } };
+    EXPECT_EQ(queue.push_batch(programs, 2, 0), 0);
+    EXPECT_EQ(queue.get(state)->first, 1);
+}
+
+TEST(HeapQueueTest, orders_programs_by_policy)
+{
+    cluster_state state{ 8, 0, std::vector<processor_state>(8) };
+    program_info programs[] = { { 2, 30 }, { 4, 10 }, { 1, 20 }, { 8, 5 } };
+
+    sjf_queue<> sjf;
+    ljf_queue<> ljf;
+    smallest_area_queue<> area;
+    widest_first_queue<> widest;
+    sjf.push_batch(programs, 4, 0);
+    ljf.push_batch(programs, 4, 0);
+    area.push_batch(programs, 4, 0);
+    widest.push_batch(programs, 4, 0);
+
+    EXPECT_EQ(sjf.get(state)->first, 3);
+    EXPECT_EQ(sjf.get(state)->first, 1);
+    EXPECT_EQ(ljf.get(state)->first, 0);
+    EXPECT_EQ(ljf.get(state)->first, 2);
+    EXPECT_EQ(area.get(state)->first, 2);
+    EXPECT_EQ(area.get(state)->first, 1);
+    EXPECT_EQ(widest.get(state)->first, 3);
+    EXPECT_EQ(widest.get(state)->first, 1);
+    EXPECT_EQ(sjf.size(), 2);
+}
+
+TEST(HeapQueueTest, head_blocks_narrower_programs)
+{
+    sjf_queue<> queue;
+    cluster_state state{ 2, 0, std::vector<processor_state>(4) };
+    queue.push({ 4, 1 }, 0);
+    queue.push({ 1, 2 }, 0);
+
+    EXPECT_FALSE(queue.get(state).has_value());
+    state.freeProcessors = 4;
+    EXPECT_EQ(queue.get(state)->first, 0);
+    EXPECT_EQ(queue.get(state)->first, 1);
+    EXPECT_FALSE(queue.get(state).has_value());
+}
+
+TEST(HeapQueueTest, aging_lets_old_programs_overtake)
+{
+    sjf_queue<1> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    queue.push({ 1, 50 }, 0);
+    queue.push({ 1, 60 }, 5);
+    queue.push({ 1, 20 }, 40);
+    queue.push({ 1, 30 }, 10);
+
+    EXPECT_EQ(queue.get(state)->first, 3);
+    EXPECT_EQ(queue.get(state)->first, 0);
+    EXPECT_EQ(queue.get(state)->first, 2);
+    EXPECT_EQ(queue.get(state)->first, 1);
+}
+
+TEST(HeapQueueTest, selects_same_programs_as_linear_scan)
+{
+    std::default_random_engine g(9);
+    std::uniform_int_distribution<uint64_t> widthDist(1, 16);
+    std::uniform_int_distribution<uint64_t> timeDist(0, 100);
+    std::uniform_int_distribution<uint64_t> freeDist(0, 16);
+    std::uniform_int_distribution<int> actionDist(0, 2);
+
+    smallest_area_queue<2> queue;
+    struct reference_record
+    {
+        uint64_t id;
+        double key;
+        uint64_t processors;
+    };
+    std::vector<reference_record> reference;
+    cluster_state state{ 0, 0, std::vector<processor_state>(16) };
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        if (actionDist(g) == 0)
+        {
+            ++state.currentTick;
+        }
+
+        if (actionDist(g) != 0)
+        {
+            program_info info{ widthDist(g), timeDist(g) };
+            uint64_t id = queue.push(info, state.currentTick);
+            reference.push_back({ id, (double)info.processors * info.executionTime + 2.0 * state.currentTick, info.processors });
+            continue;
+        }
+
+        state.freeProcessors = freeDist(g);
+        auto best = std::min_element(reference.begin(), reference.end(),
+            [](const reference_record& a, const reference_record& b) { return a.key < b.key; });
+        const bool expected = best != reference.end() && best->processors <= state.freeProcessors;
+
+        auto result = queue.get(state);
+        ASSERT_EQ(result.has_value(), expected);
+        if (expected)
+        {
+            EXPECT_EQ(result->first, best->id);
+            reference.erase(best);
+        }
+    }
+}
+
+TEST(FairShareQueueTest, keeps_submission_order_without_usage)
+{
+    fair_share_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    queue.push({ 1, 10, UINT64_MAX, 7 }, 0);
+    queue.push({ 1, 10, UINT64_MAX, 3 }, 0);
+    queue.push({ 1, 10, UINT64_MAX, 7 }, 0);
+
+    EXPECT_EQ(queue.get(state)->first, 0);
+    EXPECT_EQ(queue.get(state)->first, 1);
+    EXPECT_EQ(queue.get(state)->first, 2);
+    EXPECT_FALSE(queue.get(state).has_value());
+}
+
+TEST(FairShareQueueTest, prefers_users_with_less_usage)
+{
+    fair_share_queue<> queue;
+    cluster_state state{ 4, 0, std::vector<processor_state>(4) };
+    queue.push({ 2, 10, UINT64_MAX, 1 }, 0);
+    queue.push({ 2, 10, UINT64_MAX, 1 }, 0);
+    queue.push({ 4, 10, UINT64_MAX, 2 }, 0);
+    queue.push({ 1, 10, UINT64_MAX, 3 }, 0);
+
+    queue.on_finish({ 0, 0, 0, 20, 20, 1, 0, 1, false, false }, 20);
+    queue.on_finish({ 0, 0, 0, 20, 20, 2, 0, 2, false, false }, 20);
+    EXPECT_EQ(queue.get(state)->first, 3);
+    EXPECT_EQ(queue.get(state)->first, 0);
+
+    state.freeProcessors = 1;
+    EXPECT_FALSE(queue.get(state).has_value());
+    state.freeProcessors = 4;
+    EXPECT_EQ(queue.get(state)->first, 1);
+    EXPECT_EQ(queue.get(state)->first, 2);
+}
+
+TEST(FairShareQueueTest, usage_halves_every_half_life)
+{
+    fair_share_queue<10> queue;
+    queue.on_finish({ 0, 0, 0, 25, 25, 4, 0, 5, false, false }, 0);
+    EXPECT_DOUBLE_EQ(queue.usage(5, 0), 100.0);
+    EXPECT_DOUBLE_EQ(queue.usage(5, 10), 50.0);
+    EXPECT_DOUBLE_EQ(queue.usage(5, 30), 12.5);
+
+    queue.on_finish({ 0, 0, 0, 50, 50, 1, 0, 5, false, false }, 10);
+    EXPECT_DOUBLE_EQ(queue.usage(5, 10), 100.0);
+    EXPECT_DOUBLE_EQ(queue.usage(6, 10), 0.0);
+    EXPECT_THROW(fair_share_queue<>(0), std::invalid_argument);
+}
+
+TEST(FairShareQueueTest, light_user_overtakes_heavy_user_backlog)
+{
+    cluster_management_system<basic_queue> fifo(4);
+    cluster_management_system<fair_share_queue<>> fair(4);
+    for (int i = 0; i < 10; ++i)
+    {
+        fifo.add_program({ 4, 10, UINT64_MAX, 1 });
+        fair.add_program({ 4, 10, UINT64_MAX, 1 });
+    }
+    fifo.tick();
+    fair.tick();
+    fifo.add_program({ 4, 10, UINT64_MAX, 2 });
+    fair.add_program({ 4, 10, UINT64_MAX, 2 });
+    fifo.run_until(11);
+    fair.run_until(11);
+
+    std::vector<uint64_t> fifoUsers;
+    std::vector<uint64_t> fairUsers;
+    fifo.state().programs.for_each([&](const running_program& program) { fifoUsers.push_back(program.userId); });
+    fair.state().programs.for_each([&](const running_program& program) { fairUsers.push_back(program.userId); });
+    EXPECT_EQ(fifoUsers, std::vector<uint64_t>{ 1 });
+    EXPECT_EQ(fairUsers, std::vector<uint64_t>{ 2 });
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "ring_buffer.h"
+#include <exception>
+#include <gtest/gtest.h>
+
+TEST(RingBufferTest, can_create_with_default_constructor)
+{
+    ring_buffer<int> buffer;
+    EXPECT_TRUE(buffer.is_empty());
+    EXPECT_EQ(buffer.size(), 0);
+}
+
+TEST(RingBufferTest, can_create_with_initializer_list)
+{
+    ring_buffer<int> buffer = { 1, 2, 3 };
+    EXPECT_EQ(buffer.size(), 3);
+    EXPECT_EQ(buffer.front(), 1);
+    EXPECT_EQ(buffer.back(), 3);
+}
+
+TEST(RingBufferTest, can_push_back_and_pop_front)
+{
+    ring_buffer<int> buffer;
+    for (int i = 0; i < 100; ++i)
+    {
+        buffer.push_back(i);
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(buffer.front(), i);
+        buffer.pop_front();
+    }
+
+    EXPECT_TRUE(buffer.is_empty());
+    EXPECT_THROW(buffer.pop_front(), std::out_of_range);
+    EXPECT_THROW(buffer.front(), std::out_of_range);
+}
+
+TEST(RingBufferTest, can_pop_back)
+{
+    ring_buffer<int> buffer = { 1, 2, 3 };
+    buffer.pop_back();
+    EXPECT_EQ(buffer.size(), 2);
+    EXPECT_EQ(buffer.back(), 2);
+
+    buffer.pop_back();
+    buffer.pop_back();
+    EXPECT_THROW(buffer.pop_back(), std::out_of_range);
+}
+
+TEST(RingBufferTest, wraps_around_without_growing)
+{
+    ring_buffer<int> buffer;
+    const size_t capacity = buffer.capacity();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        buffer.push_back(i);
+        if (buffer.size() > 4)
+        {
+            buffer.pop_front();
+        }
+    }
+
+    EXPECT_EQ(buffer.capacity(), capacity);
+    EXPECT_EQ(buffer.front(), 996);
+    EXPECT_EQ(buffer.back(), 999);
+}
+
+TEST(RingBufferTest, can_erase_middle)
+{
+    ring_buffer<int> buffer = { 1, 2, 3 };
+    auto it = ++buffer.begin();
+    EXPECT_EQ(*it, 2);
+    buffer.erase(it);
+
+    EXPECT_EQ(buffer.size(), 2);
+    it = buffer.begin();
+    EXPECT_EQ(*it, 1);
+    ++it;
+    EXPECT_EQ(*it, 3);
+    ++it;
+    EXPECT_TRUE(it == buffer.end());
+}
+
+TEST(RingBufferTest, can_erase_first_and_last)
+{
+    ring_buffer<int> buffer = { 1, 2, 3, 4 };
+    buffer.erase(++buffer.begin());
+    buffer.erase(buffer.begin());
+    EXPECT_EQ(buffer.front(), 3);
+
+    auto it = buffer.begin();
+    ++it;
+    buffer.erase(it);
+    EXPECT_EQ(buffer.back(), 3);
+    EXPECT_EQ(buffer.size(), 1);
+}
+
+TEST(RingBufferTest, compacts_erased_elements)
+{
+    ring_buffer<int> buffer;
+    for (int i = 0; i < 1000; ++i)
+    {
+        buffer.push_back(i);
+    }
+
+    for (int i = 0; i < 900; ++i)
+    {
+        buffer.erase(++buffer.begin());
+    }
+
+    EXPECT_EQ(buffer.size(), 100);
+    EXPECT_LT(buffer.capacity(), 2048);
+    EXPECT_EQ(buffer.front(), 0);
+
+    int expected = 901;
+    for (auto it = ++buffer.begin(); it != buffer.end(); ++it)
+    {
+        EXPECT_EQ(*it, expected++);
+    }
+    EXPECT_EQ(expected, 1000);
+}
+
+TEST(RingBufferTest, check_iterator_errors)
+{
+    ring_buffer<int> buffer;
+    auto it = buffer.begin();
+    EXPECT_THROW(++it, std::out_of_range);
+    EXPECT_THROW(*it, std::out_of_range);
+    EXPECT_THROW(buffer.erase(it), std::out_of_range);
+}
+
+TEST(RingBufferTest, can_clear_buffer)
+{
+    ring_buffer<int> buffer = { 1, 2, 3 };
+    buffer.clear();
+    EXPECT_TRUE(buffer.is_empty());
+    EXPECT_THROW(buffer.back(), std::out_of_range);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "running_program_table.h"
+
+TEST(RunningProgramTableTest, can_insert_and_get)
+{
+    running_program_table table;
+    uint32_t slot = table.insert({ 7, 0, 1, 5, 5, 3, 0, 0, false, false });
+
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table[slot].programId, 7);
+    EXPECT_EQ(table[slot].tickEnd, 5);
+    EXPECT_EQ(table[slot].processors, 3);
+}
+
+TEST(RunningProgramTableTest, reuses_erased_slots)
+{
+    running_program_table table;
+    uint32_t first = table.insert({ 0, 0, 0, 1, 1, 1, 0, 0, false, false });
+    table.insert({ 1, 0, 0, 1, 1, 1, 0, 0, false, false });
+
+    table.erase(first);
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_THROW(table[first], std::out_of_range);
+
+    EXPECT_EQ(table.insert({ 2, 0, 0, 1, 1, 1, 0, 0, false, false }), first);
+    EXPECT_EQ(table.capacity(), 2);
+}
+
+TEST(RunningProgramTableTest, cant_erase_empty_slot)
+{
+    running_program_table table;
+    EXPECT_THROW(table.erase(0), std::out_of_range);
+}
+
+TEST(RunningProgramTableTest, iterates_only_running_programs)
+{
+    running_program_table table;
+    table.insert({ 0, 0, 0, 1, 1, 2, 0, 0, false, false });
+    uint32_t slot = table.insert({ 1, 0, 0, 1, 1, 3, 0, 0, false, false });
+    table.insert({ 2, 0, 0, 1, 1, 4, 0, 0, false, false });
+    table.erase(slot);
+
+    uint64_t processors = 0;
+    table.for_each([&](const running_program& p) { processors += p.processors; });
+    EXPECT_EQ(processors, 6);
+}
\ No newline at end of file
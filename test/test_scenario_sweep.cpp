@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "scenario_sweep.h"
+#include "planning_queue.h"
+
+static std::vector<sweep_scenario> small_sweep()
+{
+    std::vector<sweep_scenario> scenarios;
+    for (const char* policy : { "basic", "priority:10", "planning:10", "easy:100" })
+    {
+        for (uint64_t seed = 0; seed < 3; ++seed)
+        {
+            scenarios.push_back({ policy, 16, 0.002, seed, 2000 });
+        }
+    }
+    return scenarios;
+}
+
+TEST(ScenarioSweepTest, results_dont_depend_on_thread_count)
+{
+    const auto scenarios = small_sweep();
+    const auto single = run_sweep(scenarios, default_sweep_policies(), 1);
+    const auto parallel = run_sweep(scenarios, default_sweep_policies(), 4);
+
+    ASSERT_EQ(single.size(), scenarios.size());
+    ASSERT_EQ(parallel.size(), scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); ++i)
+    {
+        EXPECT_EQ(single[i].scenario.policy, scenarios[i].policy);
+        EXPECT_EQ(single[i].statistics.programs_added(), parallel[i].statistics.programs_added());
+        EXPECT_EQ(single[i].statistics.programs_done(), parallel[i].statistics.programs_done());
+        EXPECT_DOUBLE_EQ(single[i].statistics.average_load(), parallel[i].statistics.average_load());
+    }
+}
+
+TEST(ScenarioSweepTest, scenario_matches_direct_simulation)
+{
+    sweep_scenario scenario{ "planning:10", 16, 0.002, 5, 2000 };
+    auto results = run_sweep({ scenario }, default_sweep_policies(), 2);
+    cluster_statistics direct = simulate_scenario<planning_queue<10>>(scenario);
+
+    EXPECT_EQ(results[0].statistics.programs_started(), direct.programs_started());
+    EXPECT_DOUBLE_EQ(results[0].statistics.average_load(), direct.average_load());
+}
+
+TEST(ScenarioSweepTest, cant_run_unknown_policy)
+{
+    EXPECT_THROW(run_sweep({ { "unknown", 16, 0.002, 0, 10 } }, default_sweep_policies(), 1), std::invalid_argument);
+}
+
+TEST(ScenarioSweepTest, registry_sweep_matches_compiled_policies)
+{
+    const auto scenarios = small_sweep();
+    const auto compiled = run_sweep(scenarios, default_sweep_policies(), 2);
+    const auto registry = run_sweep(scenarios, default_scheduler_registry(), 2);
+
+    ASSERT_EQ(registry.size(), scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); ++i)
+    {
+        EXPECT_EQ(registry[i].statistics.programs_started(), compiled[i].statistics.programs_started());
+        EXPECT_DOUBLE_EQ(registry[i].statistics.average_load(), compiled[i].statistics.average_load());
+    }
+    EXPECT_THROW(run_sweep({ { "planning:depth=1", 16, 0.002, 0, 10 } }, default_scheduler_registry(), 1), std::invalid_argument);
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include "scheduler_registry.h"
+#include "scenario_sweep.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "heap_queue.h"
+
+TEST(SchedulerRegistryTest, parses_named_and_positional_parameters)
+{
+    const scheduler_registry& registry = default_scheduler_registry();
+
+    scheduler_spec spec = registry.parse("planning:lookahead=100");
+    EXPECT_EQ(spec.name, "planning");
+    EXPECT_EQ(spec.parameter("lookahead", 0), 100);
+
+    spec = registry.parse("priority:25");
+    EXPECT_EQ(spec.parameter("maxdelay", 0), 25);
+
+    spec = registry.parse("easy:inf");
+    EXPECT_EQ(spec.parameter("lookahead", 0), UINT64_MAX);
+
+    spec = registry.parse("fairshare:500");
+    EXPECT_EQ(spec.parameter("halflife", 0), 500);
+
+    spec = registry.parse("basic");
+    EXPECT_TRUE(spec.parameters.empty());
+    EXPECT_EQ(spec.parameter("anything", 7), 7);
+}
+
+TEST(SchedulerRegistryTest, rejects_invalid_specs)
+{
+    const scheduler_registry& registry = default_scheduler_registry();
+
+    EXPECT_THROW(registry.parse("unknown"), std::invalid_argument);
+    EXPECT_THROW(registry.parse("planning:depth=3"), std::invalid_argument);
+    EXPECT_THROW(registry.parse("planning:lookahead=-3"), std::invalid_argument);
+    EXPECT_THROW(registry.parse("planning:lookahead=1,lookahead=2"), std::invalid_argument);
+    EXPECT_THROW(registry.parse("planning:lookahead=99999999999999999999"), std::invalid_argument);
+    EXPECT_THROW(registry.parse("basic:1"), std::invalid_argument);
+    EXPECT_THROW(registry.create("sjf:aging=", 4), std::invalid_argument);
+}
+
+TEST(SchedulerRegistryTest, simulator_matches_template_instantiation)
+{
+    const sweep_scenario scenario{ "", 32, 0.003, 4, 3000 };
+
+    std::unique_ptr<cluster_simulator> easy = default_scheduler_registry().create("easy:lookahead=20", 32);
+    cluster_management_system<easy_backfill_queue<20>> easyDirect(32);
+    cluster_statistics a = drive_scenario(scenario, *easy);
+    cluster_statistics b = drive_scenario(scenario, easyDirect);
+    EXPECT_EQ(a.programs_started(), b.programs_started());
+    EXPECT_EQ(a.programs_done(), b.programs_done());
+    EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+    EXPECT_DOUBLE_EQ(a.wait_time().mean, b.wait_time().mean);
+
+    std::unique_ptr<cluster_simulator> sjf = default_scheduler_registry().create("sjf:aging=2", 32);
+    cluster_management_system<sjf_queue<2>> sjfDirect(32);
+    a = drive_scenario(scenario, *sjf);
+    b = drive_scenario(scenario, sjfDirect);
+    EXPECT_EQ(a.programs_started(), b.programs_started());
+    EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+}
+
+TEST(SchedulerRegistryTest, can_register_custom_policy)
+{
+    scheduler_registry registry;
+    registry.add<planning_queue<>>("lookahead-only", { "depth" },
+        [](const scheduler_spec& spec) { return planning_queue<>(spec.parameter("depth", 1)); });
+
+    EXPECT_TRUE(registry.contains("lookahead-only"));
+    EXPECT_FALSE(registry.contains("planning"));
+    EXPECT_EQ(registry.names(), std::vector<std::string>{ "lookahead-only" });
+
+    std::unique_ptr<cluster_simulator> simulator = registry.create("lookahead-only:depth=4", 8);
+    EXPECT_EQ(simulator->processors(), 8);
+    simulator->add_program({ 8, 5 });
+    simulator->run_until(10);
+    EXPECT_EQ(simulator->get_statistics().programs_done(), 1);
+}
+
+TEST(SchedulerRegistryTest, simulator_can_fork_and_snapshot)
+{
+    std::unique_ptr<cluster_simulator> simulator = default_scheduler_registry().create("conservative:100", 16);
+    simulator->add_programs(std::vector<program_info>{ { 16, 10 }, { 4, 3 }, { 8, 30 } });
+    simulator->tick();
+
+    std::unique_ptr<cluster_simulator> fork = simulator->fork();
+    std::unique_ptr<cluster_simulator> restored = default_scheduler_registry().create("conservative:100", 1);
+    {
+        std::stringstream buffer;
+        binary_writer writer(buffer);
+        simulator->save(writer);
+        writer.flush();
+        binary_reader reader(buffer);
+        restored->load(reader);
+    }
+
+    simulator->run_until(100);
+    fork->run_until(100);
+    restored->run_until(100);
+    EXPECT_EQ(simulator->get_statistics().programs_done(), 3);
+    EXPECT_EQ(fork->get_statistics().programs_done(), 3);
+    EXPECT_DOUBLE_EQ(restored->get_statistics().average_load(), simulator->get_statistics().average_load());
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "cluster_management_system.h"
+#include "binary_io.h"
+#include "ring_buffer.h"
+#include "basic_queue.h"
+#include "priority_queue.h"
+#include "planning_queue.h"
+#include "easy_backfill_queue.h"
+#include "conservative_backfill_queue.h"
+#include "heap_queue.h"
+#include "fair_share_queue.h"
+#include <exception>
+#include <random>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+namespace
+{
+    template<typename T>
+    void drive(cluster_management_system<T>& cms, std::default_random_engine& g, uint64_t from, uint64_t to,
+        bool earlyFinishes = false)
+    {
+        std::uniform_real_distribution<double> arrivalDist;
+        std::uniform_int_distribution<uint64_t> processorsDist(1, 32);
+        std::uniform_int_distribution<uint64_t> ticksDist(0, 100);
+
+        for (uint64_t tick = from; tick < to; ++tick)
+        {
+            if (arrivalDist(g) < 0.2)
+            {
+                cms.run_until(tick);
+                const uint64_t processors = processorsDist(g);
+                const uint64_t limit = ticksDist(g);
+                cms.add_program({ processors, limit, earlyFinishes ? limit / 2 : UINT64_MAX, tick % 4 });
+            }
+        }
+        cms.run_until(to);
+    }
+
+    template<typename T>
+    std::string snapshot(cluster_management_system<T>& cms, const std::default_random_engine& g)
+    {
+        std::ostringstream out;
+        binary_writer writer(out);
+        cms.save(writer);
+        writer.write_text(g);
+        writer.flush();
+        return out.str();
+    }
+
+    template<typename T>
+    void expect_bit_identical_continuation(bool earlyFinishes = false)
+    {
+        std::default_random_engine g(17);
+        cluster_management_system<T> original(32);
+        drive(original, g, 0, 3000, earlyFinishes);
+        const std::string checkpoint = snapshot(original, g);
+        drive(original, g, 3000, 6000, earlyFinishes);
+
+        std::default_random_engine restoredRng;
+        cluster_management_system<T> restored(1);
+        {
+            std::istringstream in(checkpoint);
+            binary_reader reader(in);
+            restored.load(reader);
+            reader.read_text(restoredRng);
+        }
+        EXPECT_EQ(restored.current_tick(), 3000);
+        EXPECT_EQ(restored.processors(), 32);
+        drive(restored, restoredRng, 3000, 6000, earlyFinishes);
+
+        cluster_statistics a = original.get_statistics();
+        cluster_statistics b = restored.get_statistics();
+        EXPECT_EQ(a.programs_added(), b.programs_added());
+        EXPECT_EQ(a.programs_started(), b.programs_started());
+        EXPECT_EQ(a.programs_done(), b.programs_done());
+        EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+        EXPECT_EQ(snapshot(original, g), snapshot(restored, restoredRng));
+    }
+}
+
+TEST(SnapshotTest, binary_io_round_trips_values)
+{
+    std::stringstream stream;
+    {
+        binary_writer writer(stream);
+        writer.write<uint64_t>(42);
+        writer.write(std::pair<uint32_t, double>{ 7, 2.5 });
+        writer.write(std::vector<uint64_t>(100000, 9));
+        writer.write(std::map<uint64_t, uint64_t>{ { 1, 2 }, { 3, 4 } });
+        writer.write(std::string("snapshot"));
+        writer.flush();
+    }
+
+    binary_reader reader(stream);
+    EXPECT_EQ(reader.read<uint64_t>(), 42);
+    std::pair<uint32_t, double> pair;
+    reader.read(pair);
+    EXPECT_EQ(pair.first, 7);
+    EXPECT_EQ(pair.second, 2.5);
+    std::vector<uint64_t> values;
+    reader.read(values);
+    EXPECT_EQ(values, std::vector<uint64_t>(100000, 9));
+    std::map<uint64_t, uint64_t> map;
+    reader.read(map);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map[3], 4);
+    EXPECT_EQ(reader.read<std::string>(), "snapshot");
+    ASSERT_ANY_THROW(reader.read<uint64_t>());
+}
+
+TEST(SnapshotTest, storages_round_trip_contents)
+{
+    linked_list<int> list = { 1, 2, 3 };
+    ring_buffer<int> buffer = { 4, 5 };
+    std::stringstream stream;
+    {
+        binary_writer writer(stream);
+        list.save(writer);
+        buffer.save(writer);
+        writer.flush();
+    }
+
+    linked_list<int> loadedList = { 9 };
+    ring_buffer<int> loadedBuffer;
+    binary_reader reader(stream);
+    loadedList.load(reader);
+    loadedBuffer.load(reader);
+
+    ASSERT_EQ(loadedList.size(), 3);
+    EXPECT_EQ(loadedList.front(), 1);
+    EXPECT_EQ(loadedList.back(), 3);
+    ASSERT_EQ(loadedBuffer.size(), 2);
+    EXPECT_EQ(loadedBuffer.front(), 4);
+    EXPECT_EQ(loadedBuffer.back(), 5);
+}
+
+TEST(SnapshotTest, basic_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<basic_queue>();
+}
+
+TEST(SnapshotTest, priority_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<priority_queue<100>>();
+}
+
+TEST(SnapshotTest, planning_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<planning_queue<100>>();
+}
+
+TEST(SnapshotTest, easy_backfill_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<easy_backfill_queue<100>>();
+}
+
+TEST(SnapshotTest, conservative_backfill_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<conservative_backfill_queue<100, ring_buffer>>();
+    expect_bit_identical_continuation<conservative_backfill_queue<100, ring_buffer>>(true);
+}
+
+TEST(SnapshotTest, heap_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<smallest_area_queue<3>>();
+}
+
+TEST(SnapshotTest, save_throws_on_write_error)
+{
+    cluster_management_system<basic_queue> cms(4);
+    cms.add_program({ 2, 10 });
+    cms.tick();
+
+    std::ostringstream out;
+    out.setstate(std::ios::badbit);
+    binary_writer writer(out);
+    EXPECT_THROW(cms.save(writer), std::runtime_error);
+}
+
+TEST(SnapshotTest, fair_share_queue_continues_bit_identically)
+{
+    expect_bit_identical_continuation<fair_share_queue<200>>();
+}
+
+TEST(SnapshotTest, throws_on_foreign_or_truncated_snapshot)
+{
+    cluster_management_system<basic_queue> cms(4);
+    {
+        std::istringstream in("definitely not a snapshot");
+        binary_reader reader(in);
+        ASSERT_ANY_THROW(cms.load(reader));
+    }
+
+    std::default_random_engine g(1);
+    cluster_management_system<basic_queue> source(32);
+    drive(source, g, 0, 200);
+    std::string data = snapshot(source, g);
+    {
+        std::istringstream in(data.substr(0, data.size() / 2));
+        binary_reader reader(in);
+        ASSERT_ANY_THROW(cms.load(reader));
+    }
+}
+
+TEST(SnapshotTest, topology_placement_continues_bit_identically)
+{
+    std::default_random_engine g(5);
+    cluster_management_system<easy_backfill_queue<100>> original(cluster_topology({ 8, 8, 16 }, 2));
+    drive(original, g, 0, 2000);
+    const std::string checkpoint = snapshot(original, g);
+    drive(original, g, 2000, 4000);
+
+    std::default_random_engine restoredRng;
+    cluster_management_system<easy_backfill_queue<100>> restored(1);
+    {
+        std::istringstream in(checkpoint);
+        binary_reader reader(in);
+        restored.load(reader);
+        reader.read_text(restoredRng);
+    }
+    drive(restored, restoredRng, 2000, 4000);
+
+    EXPECT_EQ(original.nodes_spanned(), restored.nodes_spanned());
+    EXPECT_EQ(snapshot(original, g), snapshot(restored, restoredRng));
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "swf_reader.h"
+#include "trace_replay.h"
+#include "basic_queue.h"
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <gtest/gtest.h>
+
+namespace
+{
+    const std::string sample_trace =
+        "; Version: 2.2\n"
+        "; MaxProcs: 8\n"
+        "\n"
+        "1 0 5 10 4 -1 -1 4 20 -1 1 1 1 1 1 -1 -1 -1\n"
+        "2 0 3 7 -1 -1 -1 2 -1 -1 1 3 1 1 1 -1 -1 -1\r\n"
+        "3 4 0 -1 2 -1 -1 2 10 -1 0 1 1 1 1 -1 -1 -1\n"
+        "4 6 1 2.5 16 -1 -1 16 5 -1 1 1 1 1 1 -1 -1 -1\n"
+        "5 9 0 0 1 -1 -1 1 1 -1 1 1 1 1 1 -1 -1 -1";
+}
+
+TEST(SwfReaderTest, can_read_jobs_from_buffer)
+{
+    swf_reader reader(sample_trace.data(), sample_trace.size());
+    trace_job job;
+
+    ASSERT_TRUE(reader.next(job));
+    EXPECT_EQ(job.submitTick, 0);
+    EXPECT_EQ(job.processors, 4);
+    EXPECT_EQ(job.runTime, 10);
+    EXPECT_EQ(job.requestedTime, 20);
+    EXPECT_EQ(job.userId, 1);
+
+    ASSERT_TRUE(reader.next(job));
+    EXPECT_EQ(job.submitTick, 0);
+    EXPECT_EQ(job.processors, 2);
+    EXPECT_EQ(job.runTime, 7);
+    EXPECT_EQ(job.requestedTime, 7);
+    EXPECT_EQ(job.userId, 3);
+
+    ASSERT_TRUE(reader.next(job));
+    EXPECT_EQ(job.submitTick, 6);
+    EXPECT_EQ(job.processors, 16);
+    EXPECT_EQ(job.runTime, 2);
+
+    ASSERT_TRUE(reader.next(job));
+    EXPECT_EQ(job.submitTick, 9);
+    EXPECT_EQ(job.runTime, 0);
+
+    EXPECT_FALSE(reader.next(job));
+    EXPECT_EQ(reader.skipped(), 1);
+}
+
+TEST(SwfReaderTest, throws_on_malformed_record)
+{
+    std::string trace = "1 0 5 x 4\n";
+    swf_reader reader(trace.data(), trace.size());
+    trace_job job;
+
+    ASSERT_ANY_THROW(reader.next(job));
+}
+
+TEST(SwfReaderTest, can_replay_trace_into_cluster)
+{
+    swf_reader reader(sample_trace.data(), sample_trace.size());
+    cluster_management_system<basic_queue> cms(8);
+    trace_replay<basic_queue, swf_reader> replay(cms, reader, 1);
+
+    replay.run();
+    while (cms.advance_to_next_event()) {}
+
+    cluster_statistics stats = cms.get_statistics();
+    EXPECT_TRUE(replay.is_finished());
+    EXPECT_EQ(replay.jobs_replayed(), 3);
+    EXPECT_EQ(replay.jobs_rejected(), 1);
+    EXPECT_EQ(stats.programs_added(), 3);
+    EXPECT_EQ(stats.programs_done(), 3);
+}
+
+TEST(SwfReaderTest, can_read_mapped_file)
+{
+    std::string path = testing::TempDir() + "swf_reader_test.swf";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(sample_trace.data(), 1, sample_trace.size(), file);
+    std::fclose(file);
+
+    {
+        swf_reader reader(path);
+        trace_job job;
+        int count = 0;
+        while (reader.next(job))
+        {
+            ++count;
+        }
+
+        EXPECT_EQ(count, 4);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(SwfReaderTest, throws_when_file_is_missing)
+{
+    ASSERT_ANY_THROW(swf_reader(testing::TempDir() + "swf_reader_missing.swf"));
+}
\ No newline at end of file
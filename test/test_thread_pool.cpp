@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include "thread_pool.h"
+
+TEST(ThreadPoolTest, can_run_tasks)
+{
+    thread_pool pool(4);
+    std::atomic<int> sum(0);
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        pool.submit([&sum, i]() { sum += i; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(sum, 5050);
+}
+
+TEST(ThreadPoolTest, can_submit_from_tasks)
+{
+    thread_pool pool(3);
+    std::atomic<int> count(0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        pool.submit([&]()
+        {
+            for (int j = 0; j < 10; ++j)
+            {
+                pool.submit([&count]() { ++count; });
+            }
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPoolTest, rethrows_task_exception_on_wait)
+{
+    thread_pool pool(2);
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_NO_THROW(pool.wait());
+}
+
+TEST(ThreadPoolTest, can_wait_without_tasks)
+{
+    thread_pool pool(0);
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_NO_THROW(pool.wait());
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <vector>
+#include "topology_placement.h"
+#include "cluster_management_system.h"
+#include "basic_queue.h"
+#include "easy_backfill_queue.h"
+
+namespace
+{
+    struct placed_program
+    {
+        std::vector<uint64_t> processors;
+        uint32_t nodes;
+    };
+
+    placed_program place(topology_placement& placement, free_processor_index& index, uint64_t count)
+    {
+        placed_program program;
+        program.nodes = placement.acquire(count, index, [&](uint64_t i) { program.processors.push_back(i); });
+        return program;
+    }
+
+    std::set<uint32_t> nodes_of(const cluster_topology& topology, const placed_program& program)
+    {
+        std::set<uint32_t> nodes;
+        for (uint64_t i : program.processors)
+        {
+            nodes.insert(topology.node_of(i));
+        }
+        return nodes;
+    }
+
+    void release(topology_placement& placement, free_processor_index& index, const placed_program& program)
+    {
+        std::vector<processor_state> processors(index.size());
+        for (size_t i = 0; i + 1 < program.processors.size(); ++i)
+        {
+            processors[program.processors[i]].nextProcessor = (uint32_t)program.processors[i + 1];
+        }
+
+        placement.release_chain((uint32_t)program.processors.front(), processors);
+        for (uint64_t i : program.processors)
+        {
+            index.release(i);
+        }
+    }
+}
+
+TEST(ClusterTopologyTest, numbers_processors_node_by_node)
+{
+    cluster_topology topology({ 4, 8, 2 }, 2);
+    EXPECT_EQ(topology.node_count(), 3);
+    EXPECT_EQ(topology.rack_count(), 2);
+    EXPECT_EQ(topology.processors(), 14);
+    EXPECT_EQ(topology.node_begin(1), 4);
+    EXPECT_EQ(topology.node_end(1), 12);
+    EXPECT_EQ(topology.node_of(3), 0);
+    EXPECT_EQ(topology.node_of(4), 1);
+    EXPECT_EQ(topology.node_of(13), 2);
+    EXPECT_EQ(topology.rack_of(2), 1);
+    EXPECT_THROW(topology.node_of(14), std::out_of_range);
+}
+
+TEST(ClusterTopologyTest, throws_on_empty_nodes)
+{
+    EXPECT_THROW(cluster_topology(std::vector<uint32_t>()), std::invalid_argument);
+    EXPECT_THROW(cluster_topology(2, 0), std::invalid_argument);
+}
+
+TEST(TopologyPlacementTest, small_program_takes_best_fitting_node)
+{
+    cluster_topology topology(std::vector<uint32_t>{ 8, 4, 8 });
+    topology_placement placement(topology);
+    free_processor_index index(topology.processors());
+
+    placed_program a = place(placement, index, 3);
+    EXPECT_EQ(a.nodes, 1);
+    EXPECT_EQ(nodes_of(topology, a), (std::set<uint32_t>{ 1 }));
+    EXPECT_EQ(a.processors, (std::vector<uint64_t>{ 8, 9, 10 }));
+
+    placed_program b = place(placement, index, 2);
+    EXPECT_EQ(nodes_of(topology, b).size(), 1);
+    EXPECT_NE(nodes_of(topology, b), (std::set<uint32_t>{ 1 }));
+    EXPECT_EQ(placement.node_free(1), 1);
+}
+
+TEST(TopologyPlacementTest, large_program_spans_fewest_nodes)
+{
+    cluster_topology topology({ 4, 4, 16, 4 });
+    topology_placement placement(topology);
+    free_processor_index index(topology.processors());
+
+    placed_program a = place(placement, index, 20);
+    EXPECT_EQ(a.nodes, 2);
+    EXPECT_EQ(a.processors.size(), 20);
+    EXPECT_EQ(nodes_of(topology, a).count(2), 1);
+    EXPECT_EQ(index.free_count(), 8);
+
+    release(placement, index, a);
+    for (uint32_t node = 0; node < topology.node_count(); ++node)
+    {
+        EXPECT_EQ(placement.node_free(node), topology.node_cores(node));
+    }
+    EXPECT_EQ(index.free_count(), 28);
+}
+
+TEST(TopologyPlacementTest, keeps_program_within_one_rack_when_possible)
+{
+    cluster_topology topology(8, 4, 2);
+    topology_placement placement(topology);
+    free_processor_index index(topology.processors());
+
+    place(placement, index, 4);
+    placed_program a = place(placement, index, 6);
+    std::set<uint32_t> racks;
+    for (uint32_t node : nodes_of(topology, a))
+    {
+        racks.insert(topology.rack_of(node));
+    }
+    EXPECT_EQ(a.nodes, 2);
+    EXPECT_EQ(racks.size(), 1);
+
+    placed_program b = place(placement, index, 20);
+    EXPECT_EQ(b.nodes, 5);
+    EXPECT_EQ(index.free_count(), 2);
+    EXPECT_THROW(place(placement, index, 3), std::out_of_range);
+}
+
+TEST(TopologyPlacementTest, cluster_schedules_like_flat_cluster)
+{
+    cluster_management_system<easy_backfill_queue<100>> flat(64);
+    cluster_management_system<easy_backfill_queue<100>> nodes(cluster_topology(8, 8, 2));
+    std::default_random_engine g(3);
+    std::uniform_int_distribution<uint64_t> processorsDist(1, 24);
+    std::uniform_int_distribution<uint64_t> ticksDist(1, 50);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        program_info program{ processorsDist(g), ticksDist(g) };
+        flat.add_program(program);
+        nodes.add_program(program);
+        flat.run_until(flat.current_tick() + 3);
+        nodes.run_until(nodes.current_tick() + 3);
+    }
+    flat.run_until(10000);
+    nodes.run_until(10000);
+
+    cluster_statistics a = flat.get_statistics();
+    cluster_statistics b = nodes.get_statistics();
+    EXPECT_EQ(a.programs_done(), b.programs_done());
+    EXPECT_DOUBLE_EQ(a.average_load(), b.average_load());
+    EXPECT_EQ(flat.nodes_spanned(), 0);
+    EXPECT_GE(nodes.nodes_spanned(), b.programs_started());
+}
+
+TEST(TopologyPlacementTest, added_processors_form_new_node)
+{
+    cluster_management_system<basic_queue> cms(cluster_topology(2, 4));
+    cms.add_program({ 4, 10 });
+    cms.add_program({ 4, 10 });
+    cms.add_program({ 6, 10 });
+    cms.tick();
+
+    cms.add_processors(8);
+    cms.tick();
+    EXPECT_EQ(cms.processors(), 16);
+    EXPECT_EQ(cms.get_statistics().programs_started(), 3);
+    EXPECT_EQ(cms.nodes_spanned(), 3);
+}
\ No newline at end of file